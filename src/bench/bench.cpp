@@ -0,0 +1,301 @@
+//
+// Created by adnan on 10/18/26.
+//
+// headless frame throughput benchmark, prints one JSON document
+// usage: vkBench [--frames <n>] [--warmup <n>] [--size <width>x<height>]
+//                [--instances <count>] [--pipelines <count>] [--upload-mib <n>]
+//                [--scenario <name>]... [--out <path>]
+// scenarios: triangle, instances, pipelines, uploads, resize (default: all)
+// pick the ICD with the loader's VK_DRIVER_FILES / VK_ICD_FILENAMES, e.g. lavapipe
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "vulkankit/RenderV.h"
+
+struct BenchOptions {
+  long frames = 500;
+  long warmup = 20;  //? not measured: pipeline compiles, first uploads
+  long instances = 100000;
+  uint32_t pipelines = 64;
+  uint32_t uploadMiB = 4;  //? re-uploaded every frame by the uploads scenario
+  std::vector<std::string> scenarios;
+  std::string outPath;  //? empty: stdout
+  RenderVConfig config;
+};
+
+struct BenchResult {
+  std::string name;
+  long frames = 0;
+  double seconds = 0.0;
+  double cpuSeconds = 0.0;  //? process CPU time, every thread
+  std::vector<double> frameMs;  //? wall time of each draw() call
+  double gpuFrameMs = 0.0;  //? rolling average of the "frame" GPU scope
+  double recreateMs = 0.0;
+  GpuAllocatorStats memory;
+};
+
+//* per-scenario hooks, setup runs after init, step before every frame
+struct Scenario {
+  std::string name;
+  void (*setup)(RenderV& renderer, const BenchOptions& options, Mesh& scratch);
+  void (*step)(RenderV& renderer, const BenchOptions& options, const Mesh& scratch,
+               long frame);
+};
+
+namespace {
+void fillGrid(InstanceSet& set, long count) {
+  set.clear();
+  const long side = static_cast<long>(std::ceil(std::sqrt(static_cast<double>(count))));
+  const float cell = 2.0f / static_cast<float>(side);
+  for (long i = 0; i < count; i++) {
+    set.add(-1.0f + (i % side + 0.5f) * cell, -1.0f + (i / side + 0.5f) * cell,
+            0.0f, cell, packColorUnorm8(1.0f, 1.0f, 1.0f));
+  }
+}
+
+void setupNothing(RenderV&, const BenchOptions&, Mesh&) {}
+void stepNothing(RenderV&, const BenchOptions&, const Mesh&, long) {}
+
+void setupInstances(RenderV& renderer, const BenchOptions& options, Mesh&) {
+  fillGrid(renderer.getInstanceSet(0), options.instances);
+}
+
+void setupPipelines(RenderV& renderer, const BenchOptions& options, Mesh&) {
+  //* state combinations the pipeline builder cannot dedupe, one draw each
+  const VkCullModeFlags cullModes[] = {VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT,
+                                       VK_CULL_MODE_FRONT_BIT};
+  std::vector<GraphicsPipelineDesc> descs;
+  for (uint32_t i = 0; i < options.pipelines; i++) {
+    GraphicsPipelineDesc desc = renderer.getDefaultPipelineDesc();
+    desc.cullMode = cullModes[i % 3];
+    desc.frontFace = (i / 3) % 2 ? VK_FRONT_FACE_COUNTER_CLOCKWISE
+                                 : VK_FRONT_FACE_CLOCKWISE;
+    desc.blendEnable = (i / 6) % 2 == 0;
+    descs.push_back(desc);
+  }
+  const auto pipelines = renderer.buildPipelines(descs);
+  const InstanceSet& base = renderer.getInstanceSet(0);
+  const long side = static_cast<long>(std::ceil(std::sqrt(static_cast<double>(pipelines.size()))));
+  const float cell = 2.0f / static_cast<float>(side);
+  for (size_t i = 0; i < pipelines.size(); i++) {
+    const uint32_t id = renderer.createInstanceSet(base.mesh, pipelines[i].get());
+    renderer.getInstanceSet(id).add(-1.0f + (i % side + 0.5f) * cell,
+                                    -1.0f + (i / side + 0.5f) * cell, 0.0f, cell,
+                                    packColorUnorm8(1.0f, 1.0f, 1.0f));
+  }
+}
+
+void setupUploads(RenderV& renderer, const BenchOptions& options, Mesh& scratch) {
+  //? never drawn, only a destination for the per-frame uploads
+  const size_t vertexCount =
+      (static_cast<size_t>(options.uploadMiB) << 20) / sizeof(QuantizedVertex);
+  scratch = renderer.uploadMesh(std::vector<Vertex>(vertexCount), {0, 1, 2});
+}
+
+void stepUploads(RenderV& renderer, const BenchOptions&, const Mesh& scratch,
+                 long frame) {
+  static std::vector<QuantizedVertex> data;
+  if (data.size() != scratch.vertexCount) data.resize(scratch.vertexCount);
+  data[static_cast<size_t>(frame) % data.size()].position[0] =
+      static_cast<int16_t>(frame);
+  renderer.updateMeshBuffer(scratch.vertexBuffer, 0, data.data(),
+                            sizeof(QuantizedVertex) * data.size());
+}
+
+void stepResize(RenderV& renderer, const BenchOptions& options, const Mesh&,
+                long frame) {
+  //* recreation storm: a new target size every frame
+  const VkExtent2D base = options.config.headlessExtent;
+  const uint32_t shrink = static_cast<uint32_t>(frame % 2) * 64;
+  renderer.setHeadlessExtent({base.width > 2 * shrink ? base.width - shrink : base.width,
+                              base.height > 2 * shrink ? base.height - shrink : base.height});
+}
+
+const Scenario SCENARIOS[] = {
+    {"triangle", setupNothing, stepNothing},
+    {"instances", setupInstances, stepNothing},
+    {"pipelines", setupPipelines, stepNothing},
+    {"uploads", setupUploads, stepUploads},
+    {"resize", setupNothing, stepResize},
+};
+
+double percentile(std::vector<double> sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  std::sort(sorted.begin(), sorted.end());
+  return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5)];
+}
+
+BenchResult runScenario(const Scenario& scenario, const BenchOptions& options) {
+  //? a fresh renderer per scenario so state never leaks between them
+  auto renderer = std::make_unique<RenderV>();
+  if (renderer->init(nullptr, options.config) == EXIT_FAILURE)
+    throw std::runtime_error("renderer init failed for scenario " + scenario.name);
+  Mesh scratch = {};
+  scenario.setup(*renderer, options, scratch);
+  for (long i = 0; i < options.warmup; i++) {
+    scenario.step(*renderer, options, scratch, i);
+    renderer->draw();
+  }
+  renderer->waitIdle();
+
+  BenchResult result = {};
+  result.name = scenario.name;
+  result.frames = options.frames;
+  result.frameMs.reserve(static_cast<size_t>(options.frames));
+  double recreateTotal = 0.0;  //? resize only, every frame rebuilds the targets once
+  const std::clock_t cpuStart = std::clock();
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < options.frames; i++) {
+    scenario.step(*renderer, options, scratch, options.warmup + i);
+    const auto frameStart = std::chrono::steady_clock::now();
+    renderer->draw();
+    const std::chrono::duration<double, std::milli> frameTime =
+        std::chrono::steady_clock::now() - frameStart;
+    result.frameMs.push_back(frameTime.count());
+    recreateTotal += renderer->getLastSwapChainRecreateMs();
+  }
+  renderer->waitIdle();  //? GPU work of the last frames counts too
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.seconds = elapsed.count();
+  result.cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+  result.gpuFrameMs = renderer->getGpuProfiler().getAverageMs("frame");
+  result.recreateMs = scenario.step == stepResize && options.frames > 0
+                          ? recreateTotal / static_cast<double>(options.frames)
+                          : 0.0;
+  result.memory = renderer->getMemoryStats();
+  return result;
+}
+
+std::string toJson(const BenchOptions& options, const std::vector<BenchResult>& results) {
+  std::ostringstream json;
+  json << "{\n  \"width\": " << options.config.headlessExtent.width
+       << ",\n  \"height\": " << options.config.headlessExtent.height
+       << ",\n  \"scenarios\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult& result = results[i];
+    const double frames = static_cast<double>(std::max(1L, result.frames));
+    double sum = 0.0;
+    for (const double ms : result.frameMs) sum += ms;
+    json << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\""
+         << ", \"frames\": " << result.frames
+         << ", \"fps\": " << (result.seconds > 0.0 ? frames / result.seconds : 0.0)
+         << ", \"cpuMsPerFrame\": " << result.cpuSeconds * 1000.0 / frames
+         << ", \"gpuMsPerFrame\": " << result.gpuFrameMs
+         << ", \"frameMs\": {\"avg\": " << sum / frames
+         << ", \"p50\": " << percentile(result.frameMs, 0.50)
+         << ", \"p99\": " << percentile(result.frameMs, 0.99)
+         << ", \"max\": " << percentile(result.frameMs, 1.0) << "}";
+    if (result.recreateMs > 0.0) json << ", \"recreateMs\": " << result.recreateMs;
+    json << ", \"memory\": {\"deviceAllocations\": " << result.memory.deviceAllocations
+         << ", \"subAllocations\": " << result.memory.subAllocations
+         << ", \"bytesReserved\": " << result.memory.bytesReserved
+         << ", \"bytesUsed\": " << result.memory.bytesUsed << "}}";
+  }
+  json << "\n  ]\n}\n";
+  return json.str();
+}
+
+//? whole-string decimal >= minimum, a typo must not turn into a zero result
+bool parseCount(const char* text, long minimum, long& value) {
+  char* end = nullptr;
+  errno = 0;
+  const long parsed = strtol(text, &end, 10);
+  if (end == text || *end != '\0' || errno == ERANGE || parsed < minimum) return false;
+  value = parsed;
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  options.config.headless = true;
+  options.config.pipelineCachePath = "";  //? every run compiles cold, results stay comparable
+  long count = 0;
+  bool valid = true;
+  for (int i = 1; i < argc && valid; i++) {
+    if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      valid = parseCount(argv[++i], 1, options.frames);
+    } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+      valid = parseCount(argv[++i], 0, options.warmup);
+    } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+      unsigned width = 0, height = 0;
+      if (sscanf(argv[++i], "%ux%u", &width, &height) != 2 || width == 0 || height == 0) {
+        std::cerr << "invalid --size, expected <width>x<height>" << std::endl;
+        return EXIT_FAILURE;
+      }
+      options.config.headlessExtent = {width, height};
+    } else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+      valid = parseCount(argv[++i], 1, options.instances);
+    } else if (strcmp(argv[i], "--pipelines") == 0 && i + 1 < argc) {
+      valid = parseCount(argv[++i], 1, count) && count <= UINT32_MAX;
+      options.pipelines = static_cast<uint32_t>(count);
+    } else if (strcmp(argv[i], "--upload-mib") == 0 && i + 1 < argc) {
+      valid = parseCount(argv[++i], 1, count) && count <= UINT32_MAX;
+      options.uploadMiB = static_cast<uint32_t>(count);
+    } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+      options.scenarios.emplace_back(argv[++i]);
+    } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      options.outPath = argv[++i];
+    } else {
+      valid = false;
+    }
+  }
+  if (!valid) {
+    //? counts are positive integers, --warmup may be 0
+    std::cerr << "usage: " << argv[0]
+              << " [--frames <n>] [--warmup <n>] [--size <width>x<height>] [--instances <count>]"
+                 " [--pipelines <count>] [--upload-mib <n>] [--scenario <name>]... [--out <path>]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<BenchResult> results;
+  //? the renderer logs to stdout, keep it clean for the JSON
+  std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+  try {
+    for (const auto& scenario : SCENARIOS) {
+      if (!options.scenarios.empty() &&
+          std::find(options.scenarios.begin(), options.scenarios.end(),
+                    scenario.name) == options.scenarios.end())
+        continue;
+      std::cerr << "running " << scenario.name << std::endl;
+      results.push_back(runScenario(scenario, options));
+    }
+  } catch (std::exception& e) {
+    std::cout.rdbuf(stdoutBuffer);
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout.rdbuf(stdoutBuffer);
+  if (results.empty()) {
+    std::cerr << "no scenario matched" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const std::string json = toJson(options, results);
+  if (options.outPath.empty()) {
+    std::cout << json;
+    return EXIT_SUCCESS;
+  }
+  std::ofstream file(options.outPath, std::ios::trunc);
+  file << json;
+  file.close();
+  if (!file) {
+    std::cerr << "failed to write " << options.outPath << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -1,6 +1,13 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include "vulkankit/RenderV.h"
 
 GLFWwindow* Window;
@@ -12,7 +19,7 @@ void initWindow(std::string title="Vulkan Window",int width=1320,int height=768)
         return;
     }
     glfwWindowHint(GLFW_CLIENT_API,GLFW_NO_API); // we're telling glfw not to work with OpenGL
-    glfwWindowHint(GLFW_RESIZABLE,GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE,GLFW_TRUE);
     Window = glfwCreateWindow(width,height,title.c_str(),nullptr,nullptr);
     if (!Window) {
       glfwTerminate();
@@ -21,18 +28,164 @@ void initWindow(std::string title="Vulkan Window",int width=1320,int height=768)
 
 
 }
-int main() {
+
+// whole-string decimal > 0, anything else is a usage error
+bool parsePositive(const char* text,long& value) {
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = strtol(text,&end,10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed <= 0) return false;
+    value = parsed;
+    return true;
+}
+
+// fills the default triangle set with a grid of small copies
+void scatterInstances(long count) {
+    if (count <= 0) return;
+    InstanceSet& set = renderV.getInstanceSet(0);
+    set.clear();
+    const long side = static_cast<long>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float cell = 2.0f / static_cast<float>(side);
+    for (long i = 0; i < count; i++) {
+        const float u = static_cast<float>(i % side) / static_cast<float>(side);
+        const float v = static_cast<float>(i / side) / static_cast<float>(side);
+        set.add(-1.0f + (i % side + 0.5f) * cell,-1.0f + (i / side + 0.5f) * cell,0.0f,cell,
+                packColorUnorm8(u,v,1.0f - u));
+    }
+}
+
+// usage: vkGuide [--headless <frames>] [--size <width>x<height>] [--pipeline-cache <path>] [--instances <count>] [--gpu-trace <path>] [--cpu-trace <path>]
+//                [--frames-in-flight <n>] [--present-mode fifo|fifo-relaxed|mailbox|immediate] [--low-latency] [--no-async-compute] [--archive <path>|--no-archive]
+//                [--watch-shaders]
+int runHeadless(long frames,long instances,const RenderVConfig& config) {
+    if (renderV.init(nullptr,config) == EXIT_FAILURE) return EXIT_FAILURE;
+    scatterInstances(instances);
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < frames; i++) {
+        renderV.draw();
+        CpuProfiler::markFrame();
+    }
+    renderV.waitIdle(); //? count GPU work of the last frames too
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Headless: " << frames << " frames in " << elapsed.count() * 1000.0 << " ms ("
+              << (elapsed.count() > 0.0 ? frames / elapsed.count() : 0.0) << " fps)" << std::endl;
+    if (CpuProfiler::isEnabled()) std::cout << CpuProfiler::formatFrameStats();
+    if (renderV.getGpuProfiler().isEnabled()) std::cout << renderV.getGpuProfiler().formatTable();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc,char** argv) {
+    RenderVConfig config;
+    long headlessFrames = 0;
+    long instances = 0;
+    std::string gpuTracePath;
+    std::string cpuTracePath;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i],"--headless") == 0 && i + 1 < argc) {
+            config.headless = true;
+            if (!parsePositive(argv[++i],headlessFrames)) {
+                std::cerr << "invalid --headless, expected a positive frame count" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i],"--size") == 0 && i + 1 < argc) {
+            unsigned width = 0, height = 0;
+            if (sscanf(argv[++i],"%ux%u",&width,&height) != 2 || width == 0 || height == 0) {
+                std::cerr << "invalid --size, expected <width>x<height>" << std::endl;
+                return EXIT_FAILURE;
+            }
+            config.headlessExtent = {width,height};
+        } else if (strcmp(argv[i],"--pipeline-cache") == 0 && i + 1 < argc) {
+            config.pipelineCachePath = argv[++i]; //? "" disables the on-disk cache
+        } else if (strcmp(argv[i],"--instances") == 0 && i + 1 < argc) {
+            if (!parsePositive(argv[++i],instances)) {
+                std::cerr << "invalid --instances, expected a positive count" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i],"--gpu-trace") == 0 && i + 1 < argc) {
+            gpuTracePath = argv[++i]; //? Chrome trace JSON of GPU pass timings, written on exit
+        } else if (strcmp(argv[i],"--frames-in-flight") == 0 && i + 1 < argc) {
+            long framesInFlight = 0;
+            if (!parsePositive(argv[++i],framesInFlight)) {
+                std::cerr << "invalid --frames-in-flight, expected a positive count" << std::endl; //? the renderer clamps the upper end
+                return EXIT_FAILURE;
+            }
+            config.framesInFlight = static_cast<uint32_t>(framesInFlight);
+        } else if (strcmp(argv[i],"--present-mode") == 0 && i + 1 < argc) {
+            const std::string mode = argv[++i];
+            if (mode == "fifo") config.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+            else if (mode == "fifo-relaxed") config.presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            else if (mode == "mailbox") config.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            else if (mode == "immediate") config.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            else {
+                std::cerr << "invalid --present-mode, expected fifo, fifo-relaxed, mailbox or immediate" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i],"--low-latency") == 0) {
+            config.lowLatency = true;
+        } else if (strcmp(argv[i],"--archive") == 0 && i + 1 < argc) {
+            config.assetArchive = argv[++i]; //? packed assets (vkPack), searched before the loose files
+        } else if (strcmp(argv[i],"--no-archive") == 0) {
+            config.useAssetArchive = false;
+        } else if (strcmp(argv[i],"--watch-shaders") == 0) {
+            config.shaderHotReload = true; //? recompile and swap pipelines when a GLSL file is saved
+        } else if (strcmp(argv[i],"--no-async-compute") == 0) {
+            config.asyncCompute = false; //? cull in the graphics command buffer even with a compute-only queue
+        } else if (strcmp(argv[i],"--cpu-trace") == 0 && i + 1 < argc) {
+            cpuTracePath = argv[++i]; //? Chrome trace / Perfetto JSON of CPU zones, written on exit
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--headless <frames>] [--size <width>x<height>] [--pipeline-cache <path>] [--instances <count>] [--gpu-trace <path>] [--cpu-trace <path>]"
+                         " [--frames-in-flight <n>] [--present-mode fifo|fifo-relaxed|mailbox|immediate] [--low-latency] [--no-async-compute] [--archive <path>|--no-archive]"
+                         " [--watch-shaders]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!cpuTracePath.empty()) {
+        CpuProfiler::setEnabled(true);
+        CpuProfiler::setThreadName("main");
+    }
+
+    if (config.headless) {
+        try {
+            const int result = runHeadless(headlessFrames,instances,config);
+            if (!gpuTracePath.empty()) renderV.getGpuProfiler().writeChromeTrace(gpuTracePath);
+            if (!cpuTracePath.empty()) CpuProfiler::writeChromeTrace(cpuTracePath);
+            return result;
+        }catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return -1;
+        }
+    }
+
     try {
         initWindow("Vulkan Triangle",1320,768);
-        if (renderV.init(Window) == EXIT_FAILURE) return EXIT_FAILURE;
+        if (renderV.init(Window,config) == EXIT_FAILURE) return EXIT_FAILURE;
+        scatterInstances(instances);
 
         while (!glfwWindowShouldClose(Window)) {
-            glfwPollEvents();
+            CpuProfiler::markFrame(); //? frame time includes event handling and any minimized waits
+            renderV.paceFrame(); //? low latency: input below is sampled right after the last scanout
+            {
+                CPU_ZONE("glfwPollEvents");
+                glfwPollEvents();
+            }
           if (glfwGetKey(Window,GLFW_KEY_ESCAPE) == GLFW_PRESS) {
             glfwSetWindowShouldClose(Window,GLFW_TRUE);
           }
+          int width = 0, height = 0;
+          glfwGetFramebufferSize(Window,&width,&height);
+          if (width == 0 || height == 0) {
+            glfwWaitEvents(); //? minimized, sleep until the window comes back
+            continue;
+          }
           renderV.draw();
         }
+        renderV.waitIdle();
+        if (!gpuTracePath.empty()) renderV.getGpuProfiler().writeChromeTrace(gpuTracePath);
+        if (!cpuTracePath.empty()) {
+            CpuProfiler::writeChromeTrace(cpuTracePath);
+            std::cout << CpuProfiler::formatFrameStats();
+        }
         glfwDestroyWindow(Window);
         glfwTerminate();
     }catch (std::exception& e) {
@@ -44,4 +197,4 @@ int main() {
 
 
     return 0;
-}
\ No newline at end of file
+}
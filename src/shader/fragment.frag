@@ -1,6 +1,30 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 layout (location = 0) in vec3 fragColor;
+layout (location = 1) in vec3 fragNormal;
+layout (location = 2) in vec2 fragUV;
 layout (location = 0) out vec4 finalColor; // defining final output color
+
+// bindless heap (BindlessHeap.h), resources are picked by index from the push constants
+layout (set = 0, binding = 0) uniform texture2D textures[];
+layout (std430, set = 0, binding = 1) readonly buffer Material {
+    vec4 tint;
+} materials[];
+layout (set = 0, binding = 2) uniform sampler linearSampler;
+
+// feature toggles, specialization constants set per pipeline (ShaderVariant.h)
+layout (constant_id = 1) const bool TEXTURE = true;
+layout (constant_id = 2) const bool MATERIAL = true;
+
+layout (push_constant) uniform DrawConstants {
+    vec4 positionScale;
+    vec4 positionOffset;
+    uint textureIndex;
+    uint materialIndex;
+} draw;
+
 void main(){
     finalColor = vec4(fragColor,1.0);
-}
\ No newline at end of file
+    if (TEXTURE) finalColor *= texture(sampler2D(textures[draw.textureIndex], linearSampler), fragUV);
+    if (MATERIAL) finalColor *= materials[draw.materialIndex].tint;
+}
@@ -1,20 +1,70 @@
 #version 450
 
+layout (location = 0) in vec4 inPosition; // snorm16, [-1,1] inside the mesh bounds
+layout (location = 1) in vec2 inNormal;   // snorm16 octahedral normal
+layout (location = 2) in vec4 inColor;    // unorm8 rgba
+layout (location = 3) in vec2 inUV;       // unorm16
+layout (location = 4) in vec4 instanceTransform; // per instance: xyz translation, w uniform scale
+layout (location = 5) in vec4 instanceColor;     // per instance unorm8 tint
+
+// feature toggles, specialization constants set per pipeline (ShaderVariant.h)
+layout (constant_id = 0) const bool INSTANCE_COLOR = true;
+
+// per draw constants, matches DrawConstants on the CPU side
+layout (push_constant) uniform DrawConstants {
+    vec4 positionScale;
+    vec4 positionOffset;
+    uint textureIndex;
+    uint materialIndex;
+    uvec2 userData;
+    uint visibleBase;   // 0xFFFFFFFF: instance streams, else first slot of the set in visibleObjects
+    uint transformBase; // culled sets: instance transforms in frameWords, vec4 units
+    uint colorBase;     // culled sets: instance colors in frameWords
+} draw;
+
+// per draw uniform block, bound with a dynamic offset into the frame's ring (DrawUniforms)
+layout (set = 1, binding = 0) uniform DrawUniforms {
+    mat4 transform;
+    vec4 tint;
+} drawData;
+
+// GPU culled sets: survivors' object indices (cull.comp) and the frame buffer holding the instance data
+layout (std430, set = 1, binding = 1) readonly buffer VisibleObjects {
+    uint visibleObjects[];
+};
+layout (std430, set = 1, binding = 2) readonly buffer FrameWords {
+    uint frameWords[];
+};
+
 layout (location = 0) out vec3 fragColor; // output location for frag shader...frag shader will take input from here
-// triangle vertex position
-vec3 position[3] = vec3[](
-    vec3(-0.5,-0.5,0.0),
-    vec3(0.5,-0.5,0.0),
-    vec3(0.0,0.5,0.0)
-);
-// triangle vertex colors
-vec3 colors[3] = vec3[](
-    vec3(0.0,0.15,1.0),
-    vec3(0.1,0.85,0.25),
-    vec3(1.0,0.5,0.0)
-);
+layout (location = 1) out vec3 fragNormal;
+layout (location = 2) out vec2 fragUV;
+
+// inverse of octEncodeSnorm16() in VertexLayout.h
+vec3 octDecode(vec2 e){
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main(){
-    gl_Position = vec4(position[gl_VertexIndex],1.0);
-    fragColor = colors[gl_VertexIndex];
-}
\ No newline at end of file
+    vec4 transform = instanceTransform;
+    vec4 color = instanceColor;
+    if (draw.visibleBase != 0xFFFFFFFFu) {
+        // one instance per survivor, gl_InstanceIndex counts from 0 inside the set
+        uint object = visibleObjects[draw.visibleBase + gl_InstanceIndex];
+        uint word = (draw.transformBase + object) * 4;
+        transform = uintBitsToFloat(uvec4(frameWords[word], frameWords[word + 1],
+                                          frameWords[word + 2], frameWords[word + 3]));
+        color = unpackUnorm4x8(frameWords[draw.colorBase + object]);
+    }
+    vec3 position = inPosition.xyz * draw.positionScale.xyz + draw.positionOffset.xyz;
+    position = position * transform.w + transform.xyz;
+    gl_Position = drawData.transform * vec4(position,1.0);
+    fragColor = inColor.rgb * drawData.tint.rgb;
+    if (INSTANCE_COLOR) fragColor *= color.rgb;
+    fragNormal = octDecode(inNormal);
+    fragUV = inUV;
+}
@@ -0,0 +1,127 @@
+//
+// Created by adnan on 10/18/26.
+//
+// LZ4 codec and archive round trips, registered with ctest (see CMakeLists.txt)
+// usage: vkLz4Test [<scratch archive path>]
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vulkankit/AssetArchive.h"
+#include "vulkankit/Lz4.h"
+
+namespace {
+bool roundTrip(const std::vector<uint8_t>& input, const char* label) {
+  std::vector<uint8_t> block;
+  lz4::compress(input.data(), input.size(), block);
+  if (block.size() > lz4::compressBound(input.size())) {
+    std::cerr << label << " (" << input.size()
+              << " bytes): block exceeds compressBound" << std::endl;
+    return false;
+  }
+  std::vector<uint8_t> output(input.size());
+  if (!lz4::decompress(block.data(), block.size(), output.data(), output.size()) ||
+      output != input) {
+    std::cerr << label << " (" << input.size() << " bytes): round trip mismatch"
+              << std::endl;
+    return false;
+  }
+  //? a block must not decode into a buffer of the wrong size
+  std::vector<uint8_t> larger(input.size() + 1);
+  if (lz4::decompress(block.data(), block.size(), larger.data(), larger.size())) {
+    std::cerr << label << " (" << input.size()
+              << " bytes): accepted a wrong destination size" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//* random data (incompressible, literal runs past 15), long runs (extended
+//* match lengths, overlapping copies) and every size below the 13 byte
+//* minimum the matcher needs, where the block is a single literal sequence
+bool testCodec(std::mt19937& random) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  bool passed = true;
+  for (size_t size = 0; size < 13; size++) {
+    std::vector<uint8_t> noise(size);
+    for (auto& value : noise) value = static_cast<uint8_t>(byte(random));
+    passed &= roundTrip(noise, "short random");
+    passed &= roundTrip(std::vector<uint8_t>(size, 0x41), "short run");
+  }
+  std::vector<uint8_t> noise(1 << 16);
+  for (auto& value : noise) value = static_cast<uint8_t>(byte(random));
+  passed &= roundTrip(noise, "random");
+  passed &= roundTrip(std::vector<uint8_t>(1 << 20, 0), "long run");
+  //? runs and noise interleaved, with a short period pattern in between
+  std::vector<uint8_t> mixed;
+  for (int chunk = 0; chunk < 64; chunk++) {
+    mixed.insert(mixed.end(), static_cast<size_t>(byte(random)) * 17,
+                 static_cast<uint8_t>(chunk));
+    for (int i = 0; i < 40; i++) mixed.push_back(static_cast<uint8_t>(byte(random)));
+    for (int i = 0; i < 300; i++) mixed.push_back(static_cast<uint8_t>("abc"[i % 3]));
+  }
+  passed &= roundTrip(mixed, "mixed");
+  //? the earlier copy sits more than 64 KiB back, out of reach of a match offset
+  std::vector<uint8_t> distant(noise);
+  distant.insert(distant.end(), 70000, 0x5a);
+  distant.insert(distant.end(), noise.begin(), noise.begin() + 4096);
+  passed &= roundTrip(distant, "distant repeat");
+  return passed;
+}
+
+//* --lz4 archive: compressible blobs come back expanded, the rest stored
+bool testArchive(std::mt19937& random, const std::string& path) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> assets;
+  assets.push_back({"run.bin", std::vector<uint8_t>(100000, 7)});
+  std::vector<uint8_t> noise(5000);
+  for (auto& value : noise) value = static_cast<uint8_t>(byte(random));
+  assets.push_back({"noise.bin", noise});
+  assets.push_back({"tiny.bin", {1, 2, 3}});
+
+  AssetArchiveWriter writer;
+  for (const auto& asset : assets)
+    writer.add(asset.first, asset.second.data(), asset.second.size(), true);
+  writer.write(path);
+
+  bool passed = true;
+  {
+    AssetArchive archive;
+    archive.open(path);
+    for (const auto& asset : assets) {
+      const AssetBlob blob = archive.read(asset.first);
+      if (blob.size() != asset.second.size() ||
+          std::memcmp(blob.data(), asset.second.data(), blob.size()) != 0) {
+        std::cerr << asset.first << ": archive round trip mismatch" << std::endl;
+        passed = false;
+      }
+    }
+    if (archive.find("run.bin")->compression != ArchiveCompression::Lz4) {
+      std::cerr << "run.bin: expected an lz4 blob" << std::endl;
+      passed = false;
+    }
+  }
+  std::remove(path.c_str());
+  return passed;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string archivePath = argc > 1 ? argv[1] : "lz4_test.vkpa";
+  std::mt19937 random(0x4c5a34u);  //? fixed seed, failures reproduce
+  bool passed = testCodec(random);
+  try {
+    passed &= testArchive(random, archivePath);
+  } catch (const std::runtime_error& e) {
+    std::cerr << "archive: " << e.what() << std::endl;
+    passed = false;
+  }
+  std::cout << (passed ? "lz4 tests passed" : "lz4 tests failed") << std::endl;
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
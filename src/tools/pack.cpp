@@ -0,0 +1,60 @@
+//
+// Created by adnan on 10/18/26.
+//
+// packs loose assets into one archive, see vulkankit/AssetArchive.h
+// usage: vkPack -o <archive> [--root <dir>] [--lz4] <file>...
+// assets are named by their path relative to --root (or as given without it),
+// which is the name RenderV looks them up by, e.g. "vertex.spv"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "vulkankit/AssetArchive.h"
+#include "vulkankit/MappedFile.h"
+
+int main(int argc, char* argv[]) {
+  std::string outPath;
+  std::string root;
+  bool compress = false;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outPath = argv[++i];
+    } else if (strcmp(argv[i], "--root") == 0 && i + 1 < argc) {
+      root = argv[++i];
+      if (!root.empty() && root.back() != '/' && root.back() != '\\') root += '/';
+    } else if (strcmp(argv[i], "--lz4") == 0) {
+      compress = true;  //? smaller archive, but those blobs are copied out on load
+    } else {
+      inputs.emplace_back(argv[i]);
+    }
+  }
+  if (outPath.empty() || inputs.empty()) {
+    std::cerr << "usage: vkPack -o <archive> [--root <dir>] [--lz4] <file>..." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    AssetArchiveWriter writer;
+    size_t totalBytes = 0;
+    for (const auto& input : inputs) {
+      if (!root.empty() && input.compare(0, root.size(), root) != 0) {
+        std::cerr << input << " is not under " << root << std::endl;
+        return EXIT_FAILURE;
+      }
+      const std::string name = root.empty() ? input : input.substr(root.size());
+      const MappedFile file(input);
+      writer.add(name, file.data(), file.size(), compress);
+      totalBytes += file.size();
+    }
+    writer.write(outPath);
+    std::cout << "packed " << inputs.size() << " assets (" << totalBytes
+              << " bytes) into " << outPath << std::endl;
+  } catch (const std::runtime_error& e) {
+    std::cerr << "vkPack: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
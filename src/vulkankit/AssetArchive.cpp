@@ -0,0 +1,190 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "Lz4.h"
+
+uint64_t AssetArchive::hashName(const std::string &name) {
+  //* FNV-1a, the top byte picks the bucket so it has to be well mixed
+  uint64_t hash = 14695981039346656037ull;
+  for (const char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+//# READER
+
+void AssetArchive::open(const std::string &path) {
+  this->close();
+  this->file.open(path);
+  const uint8_t *base = this->file.data();
+  const uint64_t fileSize = this->file.size();
+  if (fileSize < sizeof(ArchiveHeader))
+    throw std::runtime_error("asset archive too small: " + path);
+  const auto *candidate = reinterpret_cast<const ArchiveHeader *>(base);
+  if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      candidate->version != VERSION)
+    throw std::runtime_error("not a version 1 asset archive: " + path);
+
+  //* check every offset once here, lookups then trust the index
+  const uint64_t entriesEnd =
+      sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * uint64_t{candidate->entryCount};
+  if (entriesEnd > fileSize || candidate->namesOffset < entriesEnd ||
+      candidate->namesSize > fileSize - candidate->namesOffset ||
+      candidate->buckets[256] != candidate->entryCount)
+    throw std::runtime_error("corrupt asset archive index: " + path);
+  for (uint32_t bucket = 0; bucket < 256; bucket++) {
+    if (candidate->buckets[bucket] > candidate->buckets[bucket + 1])
+      throw std::runtime_error("corrupt asset archive buckets: " + path);
+  }
+  const auto *entryList =
+      reinterpret_cast<const ArchiveEntry *>(base + sizeof(ArchiveHeader));
+  for (uint32_t i = 0; i < candidate->entryCount; i++) {
+    const ArchiveEntry &entry = entryList[i];
+    const uint32_t bucket = static_cast<uint32_t>(entry.nameHash >> 56);
+    if (i < candidate->buckets[bucket] || i >= candidate->buckets[bucket + 1] ||
+        entry.offset > fileSize || entry.storedSize > fileSize - entry.offset ||
+        uint64_t{entry.nameOffset} + entry.nameLength > candidate->namesSize ||
+        (entry.compression != ArchiveCompression::None &&
+         entry.compression != ArchiveCompression::Lz4) ||
+        (entry.compression == ArchiveCompression::None &&
+         entry.storedSize != entry.size))
+      throw std::runtime_error("corrupt asset archive entry: " + path);
+  }
+  this->header = candidate;
+  this->entries = entryList;
+  this->names = reinterpret_cast<const char *>(base + candidate->namesOffset);
+}
+
+const ArchiveEntry *AssetArchive::find(const std::string &name) const {
+  if (this->header == nullptr) return nullptr;
+  const uint64_t hash = hashName(name);
+  const uint32_t bucket = static_cast<uint32_t>(hash >> 56);
+  const ArchiveEntry *first = this->entries + this->header->buckets[bucket];
+  const ArchiveEntry *last = this->entries + this->header->buckets[bucket + 1];
+  //? sorted within the bucket too, but buckets hold a handful of entries at most
+  for (const ArchiveEntry *entry = first; entry != last; ++entry) {
+    if (entry->nameHash != hash) continue;
+    if (entry->nameLength == name.size() &&
+        std::memcmp(this->names + entry->nameOffset, name.data(), name.size()) == 0)
+      return entry;
+  }
+  return nullptr;
+}
+
+AssetBlob AssetArchive::read(const std::string &name) const {
+  const ArchiveEntry *entry = this->find(name);
+  if (entry == nullptr) throw std::runtime_error("asset not in archive: " + name);
+  const uint8_t *stored = this->file.data() + entry->offset;
+  AssetBlob blob;
+  blob.length = static_cast<size_t>(entry->size);
+  if (entry->compression == ArchiveCompression::None) {
+    blob.bytes = stored;  //? page aligned view into the mapping
+    return blob;
+  }
+  blob.storage.resize((blob.length + 3) / 4);
+  auto *expanded = reinterpret_cast<uint8_t *>(blob.storage.data());
+  if (!lz4::decompress(stored, static_cast<size_t>(entry->storedSize), expanded,
+                       blob.length))
+    throw std::runtime_error("failed to decompress asset: " + name);
+  blob.bytes = expanded;
+  return blob;
+}
+
+void AssetArchive::close() {
+  this->file = MappedFile();
+  this->header = nullptr;
+  this->entries = nullptr;
+  this->names = nullptr;
+}
+
+//# WRITER
+
+void AssetArchiveWriter::add(const std::string &name, const void *data,
+                             size_t size, bool compress) {
+  Asset asset;
+  asset.name = name;
+  asset.size = size;
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  if (compress && size > 0) {
+    lz4::compress(bytes, size, asset.stored);
+    if (asset.stored.size() <= size - size / 8) {
+      asset.compression = ArchiveCompression::Lz4;
+      this->assets.push_back(std::move(asset));
+      return;
+    }
+  }
+  asset.stored.assign(bytes, bytes + size);
+  this->assets.push_back(std::move(asset));
+}
+
+void AssetArchiveWriter::write(const std::string &path) const {
+  std::vector<const Asset *> sorted;
+  for (const auto &asset : this->assets) sorted.push_back(&asset);
+  std::sort(sorted.begin(), sorted.end(), [](const Asset *a, const Asset *b) {
+    return AssetArchive::hashName(a->name) < AssetArchive::hashName(b->name);
+  });
+
+  ArchiveHeader header = {};
+  std::memcpy(header.magic, AssetArchive::MAGIC, sizeof(header.magic));
+  header.version = AssetArchive::VERSION;
+  header.entryCount = static_cast<uint32_t>(sorted.size());
+  header.alignment = AssetArchive::ALIGNMENT;
+  std::vector<ArchiveEntry> entries(sorted.size());
+  std::string names;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    const uint64_t hash = AssetArchive::hashName(sorted[i]->name);
+    if (i > 0 && entries[i - 1].nameHash == hash) {
+      throw std::runtime_error(
+          sorted[i]->name == sorted[i - 1]->name
+              ? "duplicate asset name: " + sorted[i]->name
+              : "asset name hash collision: " + sorted[i - 1]->name + ", " + sorted[i]->name);
+    }
+    entries[i].nameHash = hash;
+    entries[i].storedSize = sorted[i]->stored.size();
+    entries[i].size = sorted[i]->size;
+    entries[i].nameOffset = static_cast<uint32_t>(names.size());
+    entries[i].nameLength = static_cast<uint32_t>(sorted[i]->name.size());
+    entries[i].compression = sorted[i]->compression;
+    names += sorted[i]->name;
+    header.buckets[(hash >> 56) + 1]++;
+  }
+  for (uint32_t bucket = 0; bucket < 256; bucket++)
+    header.buckets[bucket + 1] += header.buckets[bucket];  //? counts -> first index
+  header.namesOffset = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * entries.size();
+  header.namesSize = names.size();
+  const auto alignUp = [](uint64_t value) {
+    return (value + AssetArchive::ALIGNMENT - 1) / AssetArchive::ALIGNMENT *
+           AssetArchive::ALIGNMENT;
+  };
+  uint64_t offset = alignUp(header.namesOffset + header.namesSize);
+  for (auto &entry : entries) {
+    entry.offset = offset;
+    offset = alignUp(offset + entry.storedSize);
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) throw std::runtime_error("failed to open " + path);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(entries.data()),
+            static_cast<std::streamsize>(sizeof(ArchiveEntry) * entries.size()));
+  out.write(names.data(), static_cast<std::streamsize>(names.size()));
+  uint64_t written = header.namesOffset + header.namesSize;
+  const std::vector<char> padding(AssetArchive::ALIGNMENT, 0);
+  for (size_t i = 0; i < sorted.size(); i++) {
+    out.write(padding.data(), static_cast<std::streamsize>(entries[i].offset - written));
+    out.write(reinterpret_cast<const char *>(sorted[i]->stored.data()),
+              static_cast<std::streamsize>(sorted[i]->stored.size()));
+    written = entries[i].offset + entries[i].storedSize;
+  }
+  out.close();
+  if (!out) throw std::runtime_error("failed to write " + path);
+}
@@ -0,0 +1,115 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+//* packed archive of shaders / meshes, one mmap instead of a file per asset.
+//* layout (little endian):
+//*   ArchiveHeader | ArchiveEntry[entryCount] sorted by nameHash | names | blobs
+//* buckets[b] is the first entry whose hash has top byte b, so a lookup is one
+//* table read plus a scan of a (tiny) bucket. blobs start on ALIGNMENT, a
+//* stored blob is used in place, an LZ4 one is expanded into its own buffer
+enum class ArchiveCompression : uint32_t { None = 0, Lz4 = 1 };
+
+struct ArchiveHeader {
+  char magic[4];  //? "VKPA"
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t alignment;  //? of every blob offset
+  uint64_t namesOffset;
+  uint64_t namesSize;
+  uint32_t buckets[257];  //? buckets[256] == entryCount
+  uint32_t reserved;
+};
+static_assert(sizeof(ArchiveHeader) == 1064);
+
+struct ArchiveEntry {
+  uint64_t nameHash;
+  uint64_t offset;  //? of the blob from the start of the file
+  uint64_t storedSize;  //? bytes in the file
+  uint64_t size;  //? bytes once decompressed
+  uint32_t nameOffset;  //? into the name table, names disambiguate hash collisions
+  uint32_t nameLength;
+  ArchiveCompression compression;
+  uint32_t reserved;
+};
+static_assert(sizeof(ArchiveEntry) == 48);
+
+//* one asset's bytes, either a view into the mapping or an owned buffer
+class AssetBlob {
+ private:
+  const uint8_t* bytes = nullptr;
+  size_t length = 0;
+  std::vector<uint32_t> storage;  //? decompressed data, word aligned for SPIR-V
+
+  friend class AssetArchive;
+
+ public:
+  AssetBlob() = default;
+  AssetBlob(const AssetBlob&) = delete;
+  AssetBlob& operator=(const AssetBlob&) = delete;
+  AssetBlob(AssetBlob&&) = default;  //? moving the vector keeps its heap buffer
+  AssetBlob& operator=(AssetBlob&&) = default;
+
+  const uint8_t* data() const { return this->bytes; }
+  size_t size() const { return this->length; }
+  bool isZeroCopy() const { return this->storage.empty(); }
+};
+
+class AssetArchive {
+ public:
+  static constexpr char MAGIC[4] = {'V', 'K', 'P', 'A'};
+  static constexpr uint32_t VERSION = 1;
+  static constexpr uint32_t ALIGNMENT = 4096;  //? page size, blobs can be mapped on their own
+
+  static uint64_t hashName(const std::string& name);
+
+ private:
+  MappedFile file;
+  const ArchiveHeader* header = nullptr;
+  const ArchiveEntry* entries = nullptr;
+  const char* names = nullptr;
+
+ public:
+  AssetArchive() = default;
+  AssetArchive(const AssetArchive&) = delete;
+  AssetArchive& operator=(const AssetArchive&) = delete;
+
+  //? validates the whole index up front, throws on a malformed archive
+  void open(const std::string& path);
+  bool isOpen() const { return this->header != nullptr; }
+  size_t size() const { return this->header ? this->header->entryCount : 0; }
+  //? nullptr when the archive has no asset of that name
+  const ArchiveEntry* find(const std::string& name) const;
+  //? throws when the asset is missing or fails to decompress
+  AssetBlob read(const std::string& name) const;
+  void close();
+};
+
+//* builds an archive in memory and writes it in one go (the packer tool)
+class AssetArchiveWriter {
+ private:
+  struct Asset {
+    std::string name;
+    uint64_t size = 0;
+    ArchiveCompression compression = ArchiveCompression::None;
+    std::vector<uint8_t> stored;
+  };
+  std::vector<Asset> assets;
+
+ public:
+  //? compress is a request: the blob stays stored when LZ4 saves less than 1/8
+  void add(const std::string& name, const void* data, size_t size, bool compress);
+  //? throws on duplicate names, hash collisions or I/O errors
+  void write(const std::string& path) const;
+};
+
+#endif  // ASSETARCHIVE_H
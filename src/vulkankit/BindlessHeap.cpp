@@ -0,0 +1,137 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "BindlessHeap.h"
+
+#include <stdexcept>
+
+void BindlessHeap::init(VkDevice logicalDevice,
+                        DescriptorLayoutCache &layoutCache, uint32_t maxImages,
+                        uint32_t maxBuffers) {
+  this->device = logicalDevice;
+  this->imageCapacity = maxImages;
+  this->bufferCapacity = maxBuffers;
+
+  VkSamplerCreateInfo samplerCreateInfo = {};
+  samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+  samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+  samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerCreateInfo.maxLod = 1000.0f;
+  if (vkCreateSampler(this->device, &samplerCreateInfo, nullptr,
+                      &this->sampler) != VK_SUCCESS)
+    throw std::runtime_error("failed to create bindless sampler");
+
+  std::vector<VkDescriptorSetLayoutBinding> bindings(3);
+  bindings[IMAGE_BINDING].binding = IMAGE_BINDING;
+  bindings[IMAGE_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  bindings[IMAGE_BINDING].descriptorCount = this->imageCapacity;
+  bindings[IMAGE_BINDING].stageFlags = VK_SHADER_STAGE_ALL;
+  bindings[BUFFER_BINDING].binding = BUFFER_BINDING;
+  bindings[BUFFER_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[BUFFER_BINDING].descriptorCount = this->bufferCapacity;
+  bindings[BUFFER_BINDING].stageFlags = VK_SHADER_STAGE_ALL;
+  bindings[SAMPLER_BINDING].binding = SAMPLER_BINDING;
+  bindings[SAMPLER_BINDING].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+  bindings[SAMPLER_BINDING].descriptorCount = 1;
+  bindings[SAMPLER_BINDING].stageFlags = VK_SHADER_STAGE_ALL;
+  bindings[SAMPLER_BINDING].pImmutableSamplers = &this->sampler;
+
+  //? update-after-bind: writes are legal while the set is bound in pending
+  //? command buffers, partially bound: unused slots may stay empty
+  const VkDescriptorBindingFlags arrayFlags =
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+  this->setLayout = layoutCache.get(
+      bindings, {arrayFlags, arrayFlags, 0},
+      VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+
+  VkDescriptorPoolSize poolSizes[3] = {};
+  poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  poolSizes[0].descriptorCount = this->imageCapacity;
+  poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  poolSizes[1].descriptorCount = this->bufferCapacity;
+  poolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+  poolSizes[2].descriptorCount = 1;
+  VkDescriptorPoolCreateInfo poolCreateInfo = {};
+  poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+  poolCreateInfo.maxSets = 1;
+  poolCreateInfo.poolSizeCount = 3;
+  poolCreateInfo.pPoolSizes = poolSizes;
+  if (vkCreateDescriptorPool(this->device, &poolCreateInfo, nullptr,
+                             &this->pool) != VK_SUCCESS)
+    throw std::runtime_error("failed to create bindless descriptor pool");
+
+  VkDescriptorSetAllocateInfo setAllocateInfo = {};
+  setAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  setAllocateInfo.descriptorPool = this->pool;
+  setAllocateInfo.descriptorSetCount = 1;
+  setAllocateInfo.pSetLayouts = &this->setLayout;
+  if (vkAllocateDescriptorSets(this->device, &setAllocateInfo, &this->set) !=
+      VK_SUCCESS)
+    throw std::runtime_error("failed to allocate bindless descriptor set");
+}
+
+uint32_t BindlessHeap::addImage(VkImageView view, VkImageLayout layout) {
+  uint32_t index;
+  if (!this->freeImages.empty()) {
+    index = this->freeImages.back();
+    this->freeImages.pop_back();
+  } else if (this->imageCount < this->imageCapacity) {
+    index = this->imageCount++;
+  } else {
+    throw std::runtime_error("bindless image heap is full");
+  }
+  VkDescriptorImageInfo imageInfo = {};
+  imageInfo.imageView = view;
+  imageInfo.imageLayout = layout;
+  VkWriteDescriptorSet write = {};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = this->set;
+  write.dstBinding = IMAGE_BINDING;
+  write.dstArrayElement = index;
+  write.descriptorCount = 1;
+  write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  write.pImageInfo = &imageInfo;
+  vkUpdateDescriptorSets(this->device, 1, &write, 0, nullptr);
+  return index;
+}
+
+uint32_t BindlessHeap::addBuffer(VkBuffer buffer, VkDeviceSize offset,
+                                 VkDeviceSize range) {
+  uint32_t index;
+  if (!this->freeBuffers.empty()) {
+    index = this->freeBuffers.back();
+    this->freeBuffers.pop_back();
+  } else if (this->bufferCount < this->bufferCapacity) {
+    index = this->bufferCount++;
+  } else {
+    throw std::runtime_error("bindless buffer heap is full");
+  }
+  VkDescriptorBufferInfo bufferInfo = {};
+  bufferInfo.buffer = buffer;
+  bufferInfo.offset = offset;
+  bufferInfo.range = range;
+  VkWriteDescriptorSet write = {};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = this->set;
+  write.dstBinding = BUFFER_BINDING;
+  write.dstArrayElement = index;
+  write.descriptorCount = 1;
+  write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  write.pBufferInfo = &bufferInfo;
+  vkUpdateDescriptorSets(this->device, 1, &write, 0, nullptr);
+  return index;
+}
+
+void BindlessHeap::destroy() {
+  if (this->device == VK_NULL_HANDLE) return;
+  vkDestroyDescriptorPool(this->device, this->pool, nullptr);
+  vkDestroySampler(this->device, this->sampler, nullptr);
+  this->device = VK_NULL_HANDLE;
+}
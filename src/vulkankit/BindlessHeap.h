@@ -0,0 +1,54 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef BINDLESSHEAP_H
+#define BINDLESSHEAP_H
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "DescriptorAllocator.h"
+
+//* one descriptor set holding every texture and storage buffer the renderer
+//* knows about. it is bound once per command buffer, draws select resources
+//* by index (push constants) and registering a resource never rebinds.
+//* binding 0: sampled images, 1: storage buffers, 2: immutable linear sampler
+//! slots are recycled immediately on release, only release resources the GPU is done with
+class BindlessHeap {
+ private:
+  VkDevice device = VK_NULL_HANDLE;
+  VkSampler sampler = VK_NULL_HANDLE;
+  VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;  //? owned by the layout cache
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  VkDescriptorSet set = VK_NULL_HANDLE;
+  uint32_t imageCapacity = 0;
+  uint32_t bufferCapacity = 0;
+  uint32_t imageCount = 0;
+  uint32_t bufferCount = 0;
+  std::vector<uint32_t> freeImages;
+  std::vector<uint32_t> freeBuffers;
+
+ public:
+  static constexpr uint32_t IMAGE_BINDING = 0;
+  static constexpr uint32_t BUFFER_BINDING = 1;
+  static constexpr uint32_t SAMPLER_BINDING = 2;
+
+  BindlessHeap() = default;
+  BindlessHeap(const BindlessHeap&) = delete;
+  BindlessHeap& operator=(const BindlessHeap&) = delete;
+
+  //! capacities must be within the device's update-after-bind limits, callers clamp them
+  void init(VkDevice logicalDevice, DescriptorLayoutCache& layoutCache,
+            uint32_t maxImages, uint32_t maxBuffers);
+  uint32_t addImage(VkImageView view, VkImageLayout layout);
+  uint32_t addBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+  void releaseImage(uint32_t index) { this->freeImages.push_back(index); }
+  void releaseBuffer(uint32_t index) { this->freeBuffers.push_back(index); }
+  VkDescriptorSetLayout getLayout() const { return this->setLayout; }
+  VkDescriptorSet getSet() const { return this->set; }
+  void destroy();
+};
+
+#endif  // BINDLESSHEAP_H
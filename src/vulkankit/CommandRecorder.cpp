@@ -0,0 +1,205 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "CommandRecorder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <stdexcept>
+
+#include "CpuProfiler.h"
+#include "InstanceSet.h"
+
+void CommandRecorder::init(VkDevice logicalDevice, uint32_t queueFamilyIndex,
+                           uint32_t framesInFlight, uint32_t threads) {
+  this->device = logicalDevice;
+  this->threadCount =
+      threads == 0 ? std::max(1u, std::thread::hardware_concurrency())
+                   : threads;
+
+  VkCommandPoolCreateInfo poolCreateInfo = {};
+  poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;  //? re-recorded every frame
+  poolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+
+  VkCommandBufferAllocateInfo cmdAllocateInfo = {};
+  cmdAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  cmdAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;  //* executed by a primary buffer, not a queue
+  cmdAllocateInfo.commandBufferCount = 1;
+
+  this->pools.assign(framesInFlight,
+                     std::vector<VkCommandPool>(this->threadCount, VK_NULL_HANDLE));
+  this->secondaries.assign(
+      framesInFlight,
+      std::vector<VkCommandBuffer>(this->threadCount, VK_NULL_HANDLE));
+  for (uint32_t frame = 0; frame < framesInFlight; frame++) {
+    for (uint32_t thread = 0; thread < this->threadCount; thread++) {
+      if (vkCreateCommandPool(this->device, &poolCreateInfo, nullptr,
+                              &this->pools[frame][thread]) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create recording command pool");
+      }
+      cmdAllocateInfo.commandPool = this->pools[frame][thread];
+      if (vkAllocateCommandBuffers(this->device, &cmdAllocateInfo,
+                                   &this->secondaries[frame][thread]) !=
+          VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate secondary command buffers");
+      }
+    }
+  }
+  if (this->threadCount > 1) this->workers.start(this->threadCount - 1);
+}
+
+void CommandRecorder::recordChunk(
+    VkCommandBuffer commandBuffer,
+    const VkCommandBufferInheritanceInfo &inheritance, const DrawItem *draws,
+    size_t drawCount, const VkViewport &viewport, const VkRect2D &scissor,
+    VkDescriptorSet uniformSet) const {
+  CPU_ZONE("recordChunk");
+  VkCommandBufferBeginInfo cmdBeginInfo = {};
+  cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                       VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;  //? lives entirely inside the render pass
+  cmdBeginInfo.pInheritanceInfo = &inheritance;
+  if (vkBeginCommandBuffer(commandBuffer, &cmdBeginInfo) != VK_SUCCESS)
+    throw std::runtime_error("failed to begin recording secondary command buffer");
+  //* dynamic state is not inherited from the primary
+  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+  vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+  if (this->globalSet != VK_NULL_HANDLE) {
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            this->globalLayout, 0, 1, &this->globalSet, 0,
+                            nullptr);
+  }
+  VkPipeline boundPipeline = VK_NULL_HANDLE;
+  VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+  VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+  uint32_t boundUniformOffset = UINT32_MAX;
+  for (size_t i = 0; i < drawCount; i++) {
+    const DrawItem &draw = draws[i];
+    if (draw.pipeline != boundPipeline) {
+      vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        draw.pipeline);
+      boundPipeline = draw.pipeline;
+    }
+    if (draw.vertexBuffer != VK_NULL_HANDLE &&
+        draw.vertexBuffer != boundVertexBuffer) {
+      const VkDeviceSize offset = 0;
+      vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw.vertexBuffer, &offset);
+      boundVertexBuffer = draw.vertexBuffer;
+    }
+    if (draw.instanceBuffer != VK_NULL_HANDLE) {
+      //? offsets differ every frame, so there is nothing to skip here
+      const VkBuffer instanceBuffers[] = {draw.instanceBuffer,
+                                          draw.instanceBuffer};
+      const VkDeviceSize instanceOffsets[] = {draw.instanceTransformOffset,
+                                              draw.instanceColorOffset};
+      vkCmdBindVertexBuffers(commandBuffer, INSTANCE_TRANSFORM_BINDING, 2,
+                             instanceBuffers, instanceOffsets);
+    }
+    if (uniformSet != VK_NULL_HANDLE && draw.uniformOffset != boundUniformOffset) {
+      //? same set, only the dynamic offset moves
+      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              this->globalLayout, 1, 1, &uniformSet, 1,
+                              &draw.uniformOffset);
+      boundUniformOffset = draw.uniformOffset;
+    }
+    if (draw.layout != VK_NULL_HANDLE) {
+      DrawConstants constants = {};
+      constants.decode = draw.decode;
+      constants.textureIndex = draw.textureIndex;
+      constants.materialIndex = draw.materialIndex;
+      constants.userData[0] = draw.userData[0];
+      constants.userData[1] = draw.userData[1];
+      constants.visibleBase = draw.visibleBase;
+      constants.transformBase =
+          static_cast<uint32_t>(draw.instanceTransformOffset / 16);
+      constants.colorBase =
+          static_cast<uint32_t>(draw.instanceColorOffset / sizeof(uint32_t));
+      vkCmdPushConstants(commandBuffer, draw.layout,
+                         VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                         0, sizeof(DrawConstants), &constants);
+    }
+    if (draw.indexBuffer == VK_NULL_HANDLE) {
+      vkCmdDraw(commandBuffer, draw.vertexCount, draw.instanceCount,
+                draw.firstVertex, draw.firstInstance);
+      continue;
+    }
+    if (draw.indexBuffer != boundIndexBuffer) {
+      vkCmdBindIndexBuffer(commandBuffer, draw.indexBuffer, 0,
+                           VK_INDEX_TYPE_UINT32);
+      boundIndexBuffer = draw.indexBuffer;
+    }
+    if (draw.indirectBuffer != VK_NULL_HANDLE) {
+      //? culled set: instanceCount was counted up by the cull pass of this frame
+      vkCmdDrawIndexedIndirect(commandBuffer, draw.indirectBuffer,
+                               draw.indirectOffset, draw.maxDrawCount,
+                               sizeof(VkDrawIndexedIndirectCommand));
+      continue;
+    }
+    vkCmdDrawIndexed(commandBuffer, draw.indexCount, draw.instanceCount,
+                     draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+  }
+  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    throw std::runtime_error("failed to stop recording secondary command buffer");
+}
+
+std::vector<VkCommandBuffer> CommandRecorder::record(
+    uint32_t frame, const VkCommandBufferInheritanceInfo &inheritance,
+    const std::vector<DrawItem> &draws, const VkViewport &viewport,
+    const VkRect2D &scissor, VkDescriptorSet uniformSet) {
+  if (draws.empty()) return {};
+  const size_t chunkCount = std::min<size_t>(
+      this->threadCount,
+      (draws.size() + MIN_DRAWS_PER_THREAD - 1) / MIN_DRAWS_PER_THREAD);
+  const size_t chunkSize = (draws.size() + chunkCount - 1) / chunkCount;
+
+  //? one reset per pool instead of one per command buffer
+  for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    vkResetCommandPool(this->device, this->pools[frame][chunk], 0);
+
+  //* chunk i always goes to pool i, so any worker may pick it up
+  std::vector<std::future<void>> jobs;
+  for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+    const size_t first = chunk * chunkSize;
+    const size_t count = std::min(chunkSize, draws.size() - first);
+    const VkCommandBuffer commandBuffer = this->secondaries[frame][chunk];
+    jobs.push_back(this->workers.submit(
+        [this, commandBuffer, &inheritance, &draws, first, count, &viewport,
+         &scissor, uniformSet](uint32_t) {
+          this->recordChunk(commandBuffer, inheritance, draws.data() + first, count,
+                      viewport, scissor, uniformSet);
+        }));
+  }
+  std::exception_ptr failure;
+  try {
+    this->recordChunk(this->secondaries[frame][0], inheritance, draws.data(),
+                std::min(chunkSize, draws.size()), viewport, scissor, uniformSet);
+  } catch (...) {
+    failure = std::current_exception();
+  }
+  //! always join every job, they reference the caller's draw list
+  for (auto &job : jobs) {
+    try {
+      job.get();
+    } catch (...) {
+      if (!failure) failure = std::current_exception();
+    }
+  }
+  if (failure) std::rethrow_exception(failure);
+
+  return std::vector<VkCommandBuffer>(
+      this->secondaries[frame].begin(),
+      this->secondaries[frame].begin() + static_cast<long>(chunkCount));
+}
+
+void CommandRecorder::destroy() {
+  this->workers.stop();
+  for (const auto &framePools : this->pools)
+    for (auto pool : framePools)
+      if (pool != VK_NULL_HANDLE)
+        vkDestroyCommandPool(this->device, pool, nullptr);
+  this->pools.clear();
+  this->secondaries.clear();
+}
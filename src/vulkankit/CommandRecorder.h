@@ -0,0 +1,56 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef COMMANDRECORDER_H
+#define COMMANDRECORDER_H
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "RenderVUtil.h"
+#include "ThreadPool.h"
+
+//* records the draw list into secondary command buffers on worker threads.
+//* every (frame in flight, thread) pair owns a VkCommandPool so workers never
+//* share a pool, and a frame's pools are reset wholesale once its timeline value passed
+class CommandRecorder {
+ private:
+  static constexpr size_t MIN_DRAWS_PER_THREAD = 64;  //? below this threading costs more than it saves
+
+  VkDevice device = VK_NULL_HANDLE;
+  uint32_t threadCount = 1;
+  ThreadPool workers;  //? threadCount - 1 workers, the calling thread records a chunk too
+  std::vector<std::vector<VkCommandPool>> pools;            //? [frame][thread]
+  std::vector<std::vector<VkCommandBuffer>> secondaries;  //? [frame][thread]
+  VkPipelineLayout globalLayout = VK_NULL_HANDLE;
+  VkDescriptorSet globalSet = VK_NULL_HANDLE;  //? bound once at the start of every secondary
+
+  void recordChunk(VkCommandBuffer commandBuffer,
+                   const VkCommandBufferInheritanceInfo& inheritance,
+                   const DrawItem* draws, size_t drawCount,
+                   const VkViewport& viewport, const VkRect2D& scissor,
+                   VkDescriptorSet uniformSet) const;
+
+ public:
+  CommandRecorder() = default;
+  CommandRecorder(const CommandRecorder&) = delete;
+  CommandRecorder& operator=(const CommandRecorder&) = delete;
+
+  void init(VkDevice logicalDevice, uint32_t queueFamilyIndex,
+            uint32_t framesInFlight, uint32_t threads);
+  //? set 0 of every graphics pipeline layout, e.g. the bindless heap
+  void setGlobalDescriptorSet(VkPipelineLayout layout, VkDescriptorSet set) {
+    this->globalLayout = layout;
+    this->globalSet = set;
+  }
+  //! caller guarantees the frame's previous submission has completed
+  //? uniformSet is set 1, rebound with each draw's uniformOffset as dynamic offset
+  std::vector<VkCommandBuffer> record(
+      uint32_t frame, const VkCommandBufferInheritanceInfo& inheritance,
+      const std::vector<DrawItem>& draws, const VkViewport& viewport,
+      const VkRect2D& scissor, VkDescriptorSet uniformSet = VK_NULL_HANDLE);
+  void destroy();
+};
+
+#endif  // COMMANDRECORDER_H
@@ -0,0 +1,184 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> CpuProfiler::enabled{false};
+
+namespace {
+struct ZoneEvent {
+  const char* name;
+  uint64_t startNs;
+  uint64_t endNs;
+};
+
+//* single writer (the owning thread), readers only look at slots below head
+struct ThreadEvents {
+  std::array<ZoneEvent, CpuProfiler::EVENTS_PER_THREAD> events = {};
+  std::atomic<uint64_t> head{0};
+  uint32_t threadId = 0;
+  std::string threadName;
+};
+
+struct Registry {
+  std::mutex mutex;  //? guards threads, taken once per thread and when dumping
+  std::vector<std::unique_ptr<ThreadEvents>> threads;  //? never freed, events outlive their thread
+  std::array<double, CpuProfiler::FRAME_HISTORY> frameMs = {};
+  std::atomic<uint64_t> frameCount{0};
+  uint64_t lastFrameNs = 0;  //? only touched by the thread calling markFrame
+  uint64_t originNs = CpuProfiler::now();
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+ThreadEvents& threadEvents() {
+  thread_local ThreadEvents* events = nullptr;
+  if (events == nullptr) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.threads.push_back(std::make_unique<ThreadEvents>());
+    events = reg.threads.back().get();
+    events->threadId = static_cast<uint32_t>(reg.threads.size());
+    events->threadName = "thread " + std::to_string(events->threadId);
+  }
+  return *events;
+}
+}  // namespace
+
+void CpuProfiler::setEnabled(bool enable) {
+  if (enable) registry();  //? pins originNs before the first zone starts
+  enabled.store(enable, std::memory_order_relaxed);
+}
+
+void CpuProfiler::setThreadName(const std::string& name) {
+  ThreadEvents& events = threadEvents();
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  events.threadName = name;
+}
+
+void CpuProfiler::record(const char* name, uint64_t startNs, uint64_t endNs) {
+  ThreadEvents& events = threadEvents();
+  const uint64_t head = events.head.load(std::memory_order_relaxed);
+  events.events[head % EVENTS_PER_THREAD] = {name, startNs, endNs};
+  events.head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::markFrame() {
+  if (!isEnabled()) return;
+  Registry& reg = registry();
+  const uint64_t current = now();
+  if (reg.lastFrameNs != 0) {
+    record("frame", reg.lastFrameNs, current);
+    const uint64_t frame = reg.frameCount.load(std::memory_order_relaxed);
+    reg.frameMs[frame % FRAME_HISTORY] =
+        static_cast<double>(current - reg.lastFrameNs) / 1e6;
+    reg.frameCount.store(frame + 1, std::memory_order_release);
+  }
+  reg.lastFrameNs = current;
+}
+
+CpuProfiler::FrameStats CpuProfiler::getFrameStats() {
+  Registry& reg = registry();
+  const uint64_t count = reg.frameCount.load(std::memory_order_acquire);
+  std::vector<double> samples(
+      reg.frameMs.begin(),
+      reg.frameMs.begin() + static_cast<long>(std::min<uint64_t>(count, FRAME_HISTORY)));
+  FrameStats stats = {};
+  if (samples.empty()) return stats;
+  std::sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for (const double ms : samples) sum += ms;
+  //? nearest rank percentiles
+  const auto percentile = [&samples](double p) {
+    const auto rank = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples[rank];
+  };
+  stats.frames = samples.size();
+  stats.averageMs = sum / static_cast<double>(samples.size());
+  stats.p50Ms = percentile(0.50);
+  stats.p99Ms = percentile(0.99);
+  stats.maxMs = samples.back();
+  return stats;
+}
+
+std::string CpuProfiler::formatFrameStats() {
+  const FrameStats stats = getFrameStats();
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "CPU frame time over %zu frames: avg %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+                stats.frames, stats.averageMs, stats.p50Ms, stats.p99Ms, stats.maxMs);
+  std::string report = line;
+  if (stats.frames == 0) return report;
+
+  //* buckets around common refresh intervals (240, 120, 60, 30, 15 Hz)
+  const double edges[] = {4.17, 8.33, 16.67, 33.33, 66.67};
+  size_t buckets[6] = {};
+  Registry& reg = registry();
+  for (size_t i = 0; i < stats.frames; i++) {
+    const double ms = reg.frameMs[i];
+    size_t bucket = 0;
+    while (bucket < 5 && ms >= edges[bucket]) bucket++;
+    buckets[bucket]++;
+  }
+  const char* labels[] = {"< 4.17",      "4.17-8.33",   "8.33-16.67",
+                          "16.67-33.33", "33.33-66.67", ">= 66.67"};
+  for (size_t bucket = 0; bucket < 6; bucket++) {
+    const size_t bar = buckets[bucket] * 50 / stats.frames;
+    std::snprintf(line, sizeof(line), "  %11s ms %8zu %s\n", labels[bucket],
+                  buckets[bucket], std::string(bar, '#').c_str());
+    report += line;
+  }
+  return report;
+}
+
+bool CpuProfiler::writeChromeTrace(const std::string& path) {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    std::cerr << "failed to open CPU trace " << path << std::endl;
+    return false;
+  }
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  //* Trace Event Format, complete ("X") events per thread of process 1
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CPU\"}}";
+  char line[256];
+  for (const auto& events : reg.threads) {
+    std::snprintf(line, sizeof(line),
+                  ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                  "\"args\":{\"name\":\"%s\"}}",
+                  events->threadId, events->threadName.c_str());
+    file << line;
+    const uint64_t head = events->head.load(std::memory_order_acquire);
+    const uint64_t first = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+    for (uint64_t i = first; i < head; i++) {
+      const ZoneEvent& event = events->events[i % EVENTS_PER_THREAD];
+      if (event.startNs < reg.originNs) continue;
+      std::snprintf(line, sizeof(line),
+                    ",\n{\"name\":\"%s\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,"
+                    "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, events->threadId,
+                    static_cast<double>(event.startNs - reg.originNs) / 1e3,
+                    static_cast<double>(event.endNs - event.startNs) / 1e3);
+      file << line;
+    }
+  }
+  file << "\n]}\n";
+  file.close();
+  if (!file) {
+    std::cerr << "failed to write CPU trace " << path << std::endl;
+    return false;
+  }
+  return true;
+}
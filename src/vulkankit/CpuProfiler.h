@@ -0,0 +1,76 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef CPUPROFILER_H
+#define CPUPROFILER_H
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+//* scoped CPU zones for the render loop. every thread writes into its own
+//* ring of events (registered once, on its first zone), so recording a zone is
+//* two clock reads and a store, no lock. markFrame() additionally keeps a ring
+//* of frame times for p50/p99/max. dumps to Chrome trace / Perfetto JSON
+class CpuProfiler {
+ public:
+  static constexpr size_t EVENTS_PER_THREAD = 1u << 14;  //? oldest zones are overwritten
+  static constexpr size_t FRAME_HISTORY = 1u << 13;  //? frame times kept for percentiles
+
+  struct FrameStats {
+    size_t frames = 0;
+    double averageMs = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+  };
+
+  static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+  //? trace time zero is the first enable
+  static void setEnabled(bool enable);
+  //? shown as the thread's name in the trace, call from the thread itself
+  static void setThreadName(const std::string& name);
+  static uint64_t now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+  //? name must outlive the profiler (a literal)
+  static void record(const char* name, uint64_t startNs, uint64_t endNs);
+  //? call once per frame from the loop thread, records a "frame" zone since the last mark
+  static void markFrame();
+  static FrameStats getFrameStats();
+  //? p50/p99/max plus a bucketed frame time histogram
+  static std::string formatFrameStats();
+  //! reads other threads' rings without locking them, dump while they are quiet (e.g. on exit)
+  static bool writeChromeTrace(const std::string& path);
+
+ private:
+  static std::atomic<bool> enabled;
+};
+
+//* RAII zone, use through CPU_ZONE("name")
+class CpuZone {
+ private:
+  const char* name;
+  uint64_t start = 0;
+
+ public:
+  explicit CpuZone(const char* zoneName) : name(zoneName) {
+    if (CpuProfiler::isEnabled()) this->start = CpuProfiler::now();
+  }
+  CpuZone(const CpuZone&) = delete;
+  CpuZone& operator=(const CpuZone&) = delete;
+  ~CpuZone() {
+    if (this->start != 0) CpuProfiler::record(this->name, this->start, CpuProfiler::now());
+  }
+};
+
+#define CPU_ZONE_CONCAT_(a, b) a##b
+#define CPU_ZONE_CONCAT(a, b) CPU_ZONE_CONCAT_(a, b)
+#define CPU_ZONE(name) CpuZone CPU_ZONE_CONCAT(cpuZone_, __LINE__)(name)
+
+#endif  // CPUPROFILER_H
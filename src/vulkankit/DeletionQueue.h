@@ -0,0 +1,70 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef DELETIONQUEUE_H
+#define DELETIONQUEUE_H
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+//* destroy callbacks keyed on graphics timeline values. a pushed callback is
+//* pending until the next frame submit stamps it with that submit's value,
+//* which the queue signals after every earlier submit, uploads included.
+//* it runs once the renderer has seen that value complete, so buffers,
+//* images and pipelines go away without a device idle
+class DeletionQueue {
+ private:
+  struct Batch {
+    uint64_t value = 0;
+    std::vector<std::function<void()>> callbacks;
+  };
+  std::vector<std::function<void()>> pendingCallbacks;  //? not stamped yet
+  std::deque<Batch> batches;  //? ascending values
+
+  static void run(std::vector<std::function<void()>>& callbacks) {
+    //? newest first, like a destructor: dependents go before what they use
+    for (auto it = callbacks.rbegin(); it != callbacks.rend(); ++it) (*it)();
+    callbacks.clear();
+  }
+
+ public:
+  DeletionQueue() = default;
+  DeletionQueue(const DeletionQueue&) = delete;
+  DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+  void push(std::function<void()> destroy) {
+    this->pendingCallbacks.push_back(std::move(destroy));
+  }
+  //! call right after a submit that signals value, every later submit signals more
+  void stamp(uint64_t value) {
+    if (this->pendingCallbacks.empty()) return;
+    this->batches.push_back({value, std::move(this->pendingCallbacks)});
+    this->pendingCallbacks.clear();
+  }
+  //? completedValue must have been reached on the GPU (waited on or queried)
+  void flush(uint64_t completedValue) {
+    while (!this->batches.empty() &&
+           this->batches.front().value <= completedValue) {
+      run(this->batches.front().callbacks);
+      this->batches.pop_front();
+    }
+  }
+  //! only once the device is idle (shutdown)
+  void flushAll() {
+    while (!this->batches.empty()) {
+      run(this->batches.front().callbacks);
+      this->batches.pop_front();
+    }
+    run(this->pendingCallbacks);
+  }
+  size_t pending() const {
+    size_t count = this->pendingCallbacks.size();
+    for (const auto& batch : this->batches) count += batch.callbacks.size();
+    return count;
+  }
+};
+
+#endif  // DELETIONQUEUE_H
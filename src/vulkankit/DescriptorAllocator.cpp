@@ -0,0 +1,214 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+void hashCombine(size_t &seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+}  // namespace
+
+bool DescriptorLayoutCache::Key::operator==(const Key &other) const {
+  if (this->flags != other.flags ||
+      this->bindings.size() != other.bindings.size() ||
+      this->bindingFlags != other.bindingFlags)
+    return false;
+  for (size_t i = 0; i < this->bindings.size(); i++) {
+    const auto &a = this->bindings[i];
+    const auto &b = other.bindings[i];
+    if (a.binding != b.binding || a.descriptorType != b.descriptorType ||
+        a.descriptorCount != b.descriptorCount ||
+        a.stageFlags != b.stageFlags ||
+        a.pImmutableSamplers != b.pImmutableSamplers)
+      return false;
+  }
+  return true;
+}
+
+size_t DescriptorLayoutCache::KeyHash::operator()(const Key &key) const {
+  size_t seed = std::hash<uint32_t>()(key.flags);
+  for (const auto &binding : key.bindings) {
+    //? binding, type, count and stages fit one 64 bit word
+    const uint64_t packed = static_cast<uint64_t>(binding.binding) |
+                            static_cast<uint64_t>(binding.descriptorType) << 8 |
+                            static_cast<uint64_t>(binding.descriptorCount) << 16 |
+                            static_cast<uint64_t>(binding.stageFlags) << 40;
+    hashCombine(seed, std::hash<uint64_t>()(packed));
+    hashCombine(seed, std::hash<const void *>()(binding.pImmutableSamplers));
+  }
+  for (const auto bindingFlags : key.bindingFlags)
+    hashCombine(seed, std::hash<uint32_t>()(bindingFlags));
+  return seed;
+}
+
+VkDescriptorSetLayout DescriptorLayoutCache::get(
+    std::vector<VkDescriptorSetLayoutBinding> bindings,
+    std::vector<VkDescriptorBindingFlags> bindingFlags,
+    VkDescriptorSetLayoutCreateFlags flags) {
+  if (!bindingFlags.empty() && bindingFlags.size() != bindings.size())
+    throw std::runtime_error("descriptor binding flags must match the bindings");
+  //? order does not matter to Vulkan, so it must not matter to the key either
+  std::vector<size_t> order(bindings.size());
+  for (size_t i = 0; i < order.size(); i++) order[i] = i;
+  std::sort(order.begin(), order.end(), [&bindings](size_t a, size_t b) {
+    return bindings[a].binding < bindings[b].binding;
+  });
+  Key key;
+  key.flags = flags;
+  for (const size_t i : order) {
+    key.bindings.push_back(bindings[i]);
+    if (!bindingFlags.empty()) key.bindingFlags.push_back(bindingFlags[i]);
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const auto found = this->layouts.find(key);
+  if (found != this->layouts.end()) return found->second;
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo = {};
+  bindingFlagsCreateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+  bindingFlagsCreateInfo.bindingCount =
+      static_cast<uint32_t>(key.bindingFlags.size());
+  bindingFlagsCreateInfo.pBindingFlags = key.bindingFlags.data();
+  VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {};
+  setLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  setLayoutCreateInfo.pNext =
+      key.bindingFlags.empty() ? nullptr : &bindingFlagsCreateInfo;
+  setLayoutCreateInfo.flags = flags;
+  setLayoutCreateInfo.bindingCount = static_cast<uint32_t>(key.bindings.size());
+  setLayoutCreateInfo.pBindings = key.bindings.data();
+  VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+  if (vkCreateDescriptorSetLayout(this->device, &setLayoutCreateInfo, nullptr,
+                                  &layout) != VK_SUCCESS)
+    throw std::runtime_error("failed to create descriptor set layout");
+  std::vector<VkDescriptorPoolSize> sizes;
+  for (const auto &binding : key.bindings) {
+    const auto same = std::find_if(sizes.begin(), sizes.end(),
+                                   [&binding](const VkDescriptorPoolSize &size) {
+                                     return size.type == binding.descriptorType;
+                                   });
+    if (same != sizes.end())
+      same->descriptorCount += binding.descriptorCount;
+    else
+      sizes.push_back({binding.descriptorType, binding.descriptorCount});
+  }
+  this->poolSizes.emplace(layout, std::move(sizes));
+  this->layouts.emplace(std::move(key), layout);
+  return layout;
+}
+
+std::vector<VkDescriptorPoolSize> DescriptorLayoutCache::getPoolSizes(
+    VkDescriptorSetLayout layout) const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const auto found = this->poolSizes.find(layout);
+  return found != this->poolSizes.end() ? found->second
+                                        : std::vector<VkDescriptorPoolSize>{};
+}
+
+void DescriptorLayoutCache::destroy() {
+  for (const auto &entry : this->layouts)
+    vkDestroyDescriptorSetLayout(this->device, entry.second, nullptr);
+  this->layouts.clear();
+  this->poolSizes.clear();
+}
+
+void DescriptorAllocator::init(VkDevice logicalDevice, uint32_t framesInFlight,
+                               const DescriptorLayoutCache *layouts) {
+  this->device = logicalDevice;
+  this->layoutCache = layouts;
+  this->frames.resize(framesInFlight);
+}
+
+VkDescriptorPool DescriptorAllocator::createPool(
+    uint32_t maxSets, const std::vector<VkDescriptorPoolSize> &perSet) const {
+  //? rough mix of what a set usually holds, scaled by the set count
+  const std::pair<VkDescriptorType, uint32_t> ratios[] = {
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4},
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+      {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2},
+      {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+      {VK_DESCRIPTOR_TYPE_SAMPLER, 1}};
+  std::vector<VkDescriptorPoolSize> poolSizes;
+  for (const auto &ratio : ratios)
+    poolSizes.push_back({ratio.first, ratio.second * maxSets});
+  //* the layout being allocated must fit maxSets times, whatever the mix says
+  for (const auto &need : perSet) {
+    const auto same = std::find_if(poolSizes.begin(), poolSizes.end(),
+                                   [&need](const VkDescriptorPoolSize &size) {
+                                     return size.type == need.type;
+                                   });
+    if (same != poolSizes.end())
+      same->descriptorCount = std::max(same->descriptorCount, need.descriptorCount * maxSets);
+    else
+      poolSizes.push_back({need.type, need.descriptorCount * maxSets});
+  }
+  VkDescriptorPoolCreateInfo poolCreateInfo = {};
+  poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolCreateInfo.flags = 0;  //! no FREE_DESCRIPTOR_SET_BIT, pools are only reset
+  poolCreateInfo.maxSets = maxSets;
+  poolCreateInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  poolCreateInfo.pPoolSizes = poolSizes.data();
+  VkDescriptorPool pool = VK_NULL_HANDLE;
+  if (vkCreateDescriptorPool(this->device, &poolCreateInfo, nullptr, &pool) !=
+      VK_SUCCESS)
+    throw std::runtime_error("failed to create descriptor pool");
+  return pool;
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(uint32_t frame,
+                                              VkDescriptorSetLayout layout) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  FramePools &framePools = this->frames[frame];
+  VkDescriptorSetAllocateInfo setAllocateInfo = {};
+  setAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  setAllocateInfo.descriptorSetCount = 1;
+  setAllocateInfo.pSetLayouts = &layout;
+  for (;;) {
+    bool freshPool = false;
+    if (framePools.active == framePools.pools.size()) {
+      //? out of pools for this frame: add a bigger one, it is kept for later frames
+      const std::vector<VkDescriptorPoolSize> perSet =
+          this->layoutCache != nullptr ? this->layoutCache->getPoolSizes(layout)
+                                       : std::vector<VkDescriptorPoolSize>{};
+      framePools.pools.push_back(this->createPool(framePools.nextPoolSets, perSet));
+      framePools.nextPoolSets =
+          std::min(framePools.nextPoolSets * 2, MAX_SETS_PER_POOL);
+      freshPool = true;
+    }
+    setAllocateInfo.descriptorPool = framePools.pools[framePools.active];
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    const VkResult result =
+        vkAllocateDescriptorSets(this->device, &setAllocateInfo, &set);
+    if (result == VK_SUCCESS) return set;
+    if (result != VK_ERROR_OUT_OF_POOL_MEMORY &&
+        result != VK_ERROR_FRAGMENTED_POOL)
+      throw std::runtime_error("failed to allocate descriptor set");
+    //! an empty pool that cannot hold the set never will, another one would not either
+    if (freshPool)
+      throw std::runtime_error("descriptor set layout does not fit a new pool");
+    framePools.active++;
+  }
+}
+
+void DescriptorAllocator::reset(uint32_t frame) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  FramePools &framePools = this->frames[frame];
+  //? one call per pool frees every set allocated from it
+  for (size_t i = 0; i < framePools.pools.size() && i <= framePools.active; i++)
+    vkResetDescriptorPool(this->device, framePools.pools[i], 0);
+  framePools.active = 0;
+}
+
+void DescriptorAllocator::destroy() {
+  for (auto &framePools : this->frames)
+    for (auto pool : framePools.pools)
+      vkDestroyDescriptorPool(this->device, pool, nullptr);
+  this->frames.clear();
+}
@@ -0,0 +1,85 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef DESCRIPTORALLOCATOR_H
+#define DESCRIPTORALLOCATOR_H
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//* deduplicates VkDescriptorSetLayouts: equal binding lists share one layout
+class DescriptorLayoutCache {
+ private:
+  struct Key {
+    std::vector<VkDescriptorSetLayoutBinding> bindings;  //? sorted by binding
+    std::vector<VkDescriptorBindingFlags> bindingFlags;  //? empty or one per binding
+    VkDescriptorSetLayoutCreateFlags flags = 0;
+    bool operator==(const Key& other) const;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  std::unordered_map<Key, VkDescriptorSetLayout, KeyHash> layouts;
+  std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorPoolSize>> poolSizes;  //? per set
+  mutable std::mutex mutex;
+
+ public:
+  DescriptorLayoutCache() = default;
+  DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+  DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+  void init(VkDevice logicalDevice) { this->device = logicalDevice; }
+  //? layouts live until destroy(), callers never destroy them
+  VkDescriptorSetLayout get(std::vector<VkDescriptorSetLayoutBinding> bindings,
+                            std::vector<VkDescriptorBindingFlags> bindingFlags = {},
+                            VkDescriptorSetLayoutCreateFlags flags = 0);
+  //? descriptors one set of a cached layout holds, by type (empty when unknown)
+  std::vector<VkDescriptorPoolSize> getPoolSizes(VkDescriptorSetLayout layout) const;
+  size_t size() const { return this->layouts.size(); }
+  void destroy();
+};
+
+//* transient descriptor sets for one frame. every frame in flight owns a
+//* growable list of pools, all of them are reset with vkResetDescriptorPool
+//* once the frame's timeline value is reached, sets are never freed one by one
+class DescriptorAllocator {
+ private:
+  static constexpr uint32_t INITIAL_SETS_PER_POOL = 64;
+  static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+  struct FramePools {
+    std::vector<VkDescriptorPool> pools;
+    size_t active = 0;  //? pools before this one ran out this frame
+    uint32_t nextPoolSets = INITIAL_SETS_PER_POOL;
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  const DescriptorLayoutCache* layoutCache = nullptr;  //? not owned, sizes pools for unusual layouts
+  std::vector<FramePools> frames;
+  std::mutex mutex;
+
+  VkDescriptorPool createPool(uint32_t maxSets,
+                              const std::vector<VkDescriptorPoolSize>& perSet) const;
+
+ public:
+  DescriptorAllocator() = default;
+  DescriptorAllocator(const DescriptorAllocator&) = delete;
+  DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+  //? layouts from layoutCache get pools that fit them even when the default mix does not
+  void init(VkDevice logicalDevice, uint32_t framesInFlight,
+            const DescriptorLayoutCache* layouts = nullptr);
+  //? valid until the frame comes around again and reset() is called,
+  //! throws when even a new pool sized for the layout cannot hold the set
+  VkDescriptorSet allocate(uint32_t frame, VkDescriptorSetLayout layout);
+  //! only after the frame's timeline value is reached
+  void reset(uint32_t frame);
+  void destroy();
+};
+
+#endif  // DESCRIPTORALLOCATOR_H
@@ -0,0 +1,370 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "GpuAllocator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+VkDeviceSize nextPowerOfTwo(VkDeviceSize value) {
+  VkDeviceSize result = 1;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+VkDeviceSize previousPowerOfTwo(VkDeviceSize value) {
+  VkDeviceSize result = 1;
+  while ((result << 1) <= value) result <<= 1;
+  return result;
+}
+
+uint32_t log2Of(VkDeviceSize powerOfTwo) {
+  uint32_t result = 0;
+  while ((VkDeviceSize{1} << result) < powerOfTwo) result++;
+  return result;
+}
+}  // namespace
+
+//# BUDDY BLOCK
+
+BuddyBlock::BuddyBlock(VkDeviceSize blockSize)
+    : size(blockSize), maxOrder(log2Of(blockSize / MIN_SIZE)) {
+  this->freeLists.resize(this->maxOrder + 1);
+  this->freeLists[this->maxOrder].insert(0);  //? whole block starts free
+}
+
+bool BuddyBlock::allocate(VkDeviceSize requestSize, VkDeviceSize alignment,
+                          VkDeviceSize &offset, VkDeviceSize &allocatedSize) {
+  //? buddies are aligned to their own size, so alignment just bumps the size
+  const VkDeviceSize needed =
+      nextPowerOfTwo(std::max({requestSize, alignment, MIN_SIZE}));
+  const uint32_t order = log2Of(needed / MIN_SIZE);
+  if (order > this->maxOrder) return false;
+
+  uint32_t available = order;
+  while (available <= this->maxOrder && this->freeLists[available].empty())
+    available++;
+  if (available > this->maxOrder) return false;
+
+  offset = *this->freeLists[available].begin();
+  this->freeLists[available].erase(this->freeLists[available].begin());
+  //* split down, handing the upper halves back to the free lists
+  while (available > order) {
+    available--;
+    this->freeLists[available].insert(offset + (MIN_SIZE << available));
+  }
+  this->usedOrders[offset] = order;
+  allocatedSize = MIN_SIZE << order;
+  this->used += allocatedSize;
+  return true;
+}
+
+void BuddyBlock::free(VkDeviceSize offset) {
+  const auto it = this->usedOrders.find(offset);
+  if (it == this->usedOrders.end())
+    throw std::logic_error("buddy block: freeing unknown offset");
+  uint32_t order = it->second;
+  this->usedOrders.erase(it);
+  this->used -= MIN_SIZE << order;
+  //* merge with the buddy as long as it is free too
+  while (order < this->maxOrder) {
+    const VkDeviceSize buddy = offset ^ (MIN_SIZE << order);
+    if (this->freeLists[order].erase(buddy) == 0) break;
+    offset = std::min(offset, buddy);
+    order++;
+  }
+  this->freeLists[order].insert(offset);
+}
+
+//# GPU ALLOCATOR
+
+void GpuAllocator::init(VkPhysicalDevice physicalDevice,
+                        VkDevice logicalDevice, VkDeviceSize blockSize) {
+  this->device = logicalDevice;
+  this->preferredBlockSize = previousPowerOfTwo(blockSize);
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &this->memoryProperties);
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  this->bufferImageGranularity = properties.limits.bufferImageGranularity;
+  this->maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+}
+
+uint32_t GpuAllocator::findMemoryType(uint32_t typeBits,
+                                      VkMemoryPropertyFlags required,
+                                      VkMemoryPropertyFlags preferred) const {
+  //? first pass asks for the nice-to-have flags too, second pass settles for required
+  for (const VkMemoryPropertyFlags wanted : {required | preferred, required}) {
+    for (uint32_t i = 0; i < this->memoryProperties.memoryTypeCount; i++) {
+      if ((typeBits & (1u << i)) &&
+          (this->memoryProperties.memoryTypes[i].propertyFlags & wanted) ==
+              wanted) {
+        return i;
+      }
+    }
+  }
+  throw std::runtime_error("failed to find suitable memory type");
+}
+
+GpuAllocator::Pool &GpuAllocator::getPool(uint32_t memoryType,
+                                          ResourceKind kind) {
+  for (auto &pool : this->pools)
+    if (pool.memoryType == memoryType && pool.kind == kind) return pool;
+
+  //? small heaps (BAR, integrated carve-outs) get smaller blocks
+  const auto heapIndex = this->memoryProperties.memoryTypes[memoryType].heapIndex;
+  const VkDeviceSize heapSize = this->memoryProperties.memoryHeaps[heapIndex].size;
+  Pool pool;
+  pool.memoryType = memoryType;
+  pool.kind = kind;
+  pool.blockSize = std::max<VkDeviceSize>(
+      1ull << 20, std::min(this->preferredBlockSize, previousPowerOfTwo(heapSize / 8)));
+  this->pools.push_back(std::move(pool));
+  return this->pools.back();
+}
+
+VkDeviceMemory GpuAllocator::allocateDeviceMemory(VkDeviceSize size,
+                                                  uint32_t memoryType,
+                                                  void **mapped) {
+  if (this->maxAllocationCount != 0 &&
+      this->stats.deviceAllocations >= this->maxAllocationCount) {
+    throw std::runtime_error("exceeded maxMemoryAllocationCount");
+  }
+  VkMemoryAllocateInfo allocateInfo = {};
+  allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocateInfo.allocationSize = size;
+  allocateInfo.memoryTypeIndex = memoryType;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if (vkAllocateMemory(this->device, &allocateInfo, nullptr, &memory) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to allocate device memory");
+  }
+  *mapped = nullptr;
+  if (this->memoryProperties.memoryTypes[memoryType].propertyFlags &
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+    if (vkMapMemory(this->device, memory, 0, VK_WHOLE_SIZE, 0, mapped) !=
+        VK_SUCCESS) {
+      vkFreeMemory(this->device, memory, nullptr);
+      throw std::runtime_error("failed to map device memory");
+    }
+  }
+  this->stats.deviceAllocations++;
+  this->stats.bytesReserved += size;
+  return memory;
+}
+
+void GpuAllocator::freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size,
+                                    bool mapped) {
+  if (mapped) vkUnmapMemory(this->device, memory);
+  vkFreeMemory(this->device, memory, nullptr);
+  this->stats.deviceAllocations--;
+  this->stats.bytesReserved -= size;
+}
+
+GpuAllocation GpuAllocator::allocate(const VkMemoryRequirements &requirements,
+                                     VkMemoryPropertyFlags required,
+                                     VkMemoryPropertyFlags preferred,
+                                     ResourceKind kind) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  GpuAllocation allocation = {};
+  allocation.memoryType =
+      this->findMemoryType(requirements.memoryTypeBits, required, preferred);
+  Pool &pool = this->getPool(allocation.memoryType, kind);
+  const auto poolIndex = static_cast<uint32_t>(&pool - this->pools.data());
+
+  //* big resources get their own memory object instead of hogging a block
+  if (requirements.size > pool.blockSize / 2) {
+    allocation.memory = this->allocateDeviceMemory(
+        requirements.size, allocation.memoryType, &allocation.mapped);
+    allocation.size = requirements.size;
+    this->stats.subAllocations++;
+    this->stats.bytesUsed += allocation.size;
+    return allocation;
+  }
+
+  const auto subAllocate = [&](uint32_t blockIndex) {
+    BuddyBlock &block = *pool.blocks[blockIndex];
+    if (!block.allocate(requirements.size, requirements.alignment,
+                        allocation.offset, allocation.size))
+      return false;
+    allocation.memory = block.memory;
+    allocation.mapped =
+        block.mapped ? static_cast<char *>(block.mapped) + allocation.offset
+                     : nullptr;
+    allocation.poolIndex = poolIndex;
+    allocation.blockIndex = blockIndex;
+    this->stats.subAllocations++;
+    this->stats.bytesUsed += allocation.size;
+    return true;
+  };
+
+  for (uint32_t i = 0; i < pool.blocks.size(); i++)
+    if (pool.blocks[i] && subAllocate(i)) return allocation;
+
+  //? every block is full, open a new one (reusing a released slot if any)
+  auto slot = static_cast<uint32_t>(
+      std::find(pool.blocks.begin(), pool.blocks.end(), nullptr) -
+      pool.blocks.begin());
+  if (slot == pool.blocks.size()) pool.blocks.emplace_back();
+  auto block = std::make_unique<BuddyBlock>(pool.blockSize);
+  block->memory = this->allocateDeviceMemory(pool.blockSize, pool.memoryType,
+                                             &block->mapped);
+  pool.blocks[slot] = std::move(block);
+  if (!subAllocate(slot))
+    throw std::runtime_error("failed to sub-allocate from a fresh block");
+  return allocation;
+}
+
+void GpuAllocator::free(GpuAllocation &allocation) {
+  if (allocation.memory == VK_NULL_HANDLE) return;
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stats.subAllocations--;
+  this->stats.bytesUsed -= allocation.size;
+  if (allocation.poolIndex == UINT32_MAX) {
+    this->freeDeviceMemory(allocation.memory, allocation.size,
+                           allocation.mapped != nullptr);
+  } else {
+    Pool &pool = this->pools[allocation.poolIndex];
+    auto &block = pool.blocks[allocation.blockIndex];
+    block->free(allocation.offset);
+    //? keep one empty block around per pool to avoid allocate/free ping-pong
+    const auto liveBlocks = std::count_if(
+        pool.blocks.begin(), pool.blocks.end(),
+        [](const std::unique_ptr<BuddyBlock> &b) { return b != nullptr; });
+    if (block->getAllocationCount() == 0 && liveBlocks > 1) {
+      this->freeDeviceMemory(block->memory, block->getSize(),
+                             block->mapped != nullptr);
+      block.reset();
+    }
+  }
+  allocation = {};
+}
+
+GpuBuffer GpuAllocator::createBuffer(VkDeviceSize size,
+                                     VkBufferUsageFlags usage,
+                                     VkMemoryPropertyFlags required,
+                                     VkMemoryPropertyFlags preferred,
+                                     const std::vector<uint32_t> &sharedFamilies) {
+  VkBufferCreateInfo bufferCreateInfo = {};
+  bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferCreateInfo.size = size;
+  bufferCreateInfo.usage = usage;
+  bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  if (sharedFamilies.size() > 1) {
+    //? read and written by several queue families without ownership transfers
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    bufferCreateInfo.queueFamilyIndexCount =
+        static_cast<uint32_t>(sharedFamilies.size());
+    bufferCreateInfo.pQueueFamilyIndices = sharedFamilies.data();
+  }
+  GpuBuffer buffer = {};
+  if (vkCreateBuffer(this->device, &bufferCreateInfo, nullptr,
+                     &buffer.buffer) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create buffer");
+  }
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(this->device, buffer.buffer, &requirements);
+  try {
+    buffer.allocation =
+        this->allocate(requirements, required, preferred, ResourceKind::Linear);
+  } catch (...) {
+    vkDestroyBuffer(this->device, buffer.buffer, nullptr);
+    throw;
+  }
+  vkBindBufferMemory(this->device, buffer.buffer, buffer.allocation.memory,
+                     buffer.allocation.offset);
+  return buffer;
+}
+
+void GpuAllocator::destroyBuffer(GpuBuffer &buffer) {
+  if (buffer.buffer != VK_NULL_HANDLE)
+    vkDestroyBuffer(this->device, buffer.buffer, nullptr);
+  this->free(buffer.allocation);
+  buffer.buffer = VK_NULL_HANDLE;
+}
+
+GpuImage GpuAllocator::createImage(const VkImageCreateInfo &imageCreateInfo,
+                                   VkMemoryPropertyFlags required) {
+  GpuImage image = {};
+  if (vkCreateImage(this->device, &imageCreateInfo, nullptr, &image.image) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create image");
+  }
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(this->device, image.image, &requirements);
+  const ResourceKind kind = imageCreateInfo.tiling == VK_IMAGE_TILING_OPTIMAL
+                                ? ResourceKind::Optimal
+                                : ResourceKind::Linear;
+  try {
+    image.allocation = this->allocate(requirements, required, 0, kind);
+  } catch (...) {
+    vkDestroyImage(this->device, image.image, nullptr);
+    throw;
+  }
+  vkBindImageMemory(this->device, image.image, image.allocation.memory,
+                    image.allocation.offset);
+  return image;
+}
+
+void GpuAllocator::destroyImage(GpuImage &image) {
+  if (image.image != VK_NULL_HANDLE)
+    vkDestroyImage(this->device, image.image, nullptr);
+  this->free(image.allocation);
+  image.image = VK_NULL_HANDLE;
+}
+
+GpuAllocatorStats GpuAllocator::getStats() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->stats;
+}
+
+void GpuAllocator::destroy() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->stats.subAllocations != 0)
+    std::cerr << "GpuAllocator: " << this->stats.subAllocations
+              << " allocations leaked at shutdown\n";
+  for (auto &pool : this->pools) {
+    for (auto &block : pool.blocks) {
+      if (!block) continue;
+      this->freeDeviceMemory(block->memory, block->getSize(),
+                             block->mapped != nullptr);
+    }
+  }
+  this->pools.clear();
+}
+
+//# LINEAR ARENA
+
+void LinearArena::init(GpuAllocator &gpuAllocator, VkDeviceSize size,
+                       VkBufferUsageFlags usage,
+                       VkMemoryPropertyFlags required,
+                       const std::vector<uint32_t> &sharedFamilies) {
+  this->allocator = &gpuAllocator;
+  this->capacity = size;
+  this->buffer = gpuAllocator.createBuffer(size, usage, required, 0, sharedFamilies);
+  this->head = 0;
+}
+
+BufferSlice LinearArena::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+  if (alignment == 0) alignment = 1;
+  const VkDeviceSize offset = (this->head + alignment - 1) / alignment * alignment;
+  if (offset + size > this->capacity)
+    throw std::runtime_error("linear arena exhausted");
+  this->head = offset + size;
+  this->peak = std::max(this->peak, this->head);
+  BufferSlice slice = {};
+  slice.buffer = this->buffer.buffer;
+  slice.offset = offset;
+  slice.size = size;
+  slice.mapped = this->buffer.allocation.mapped
+                     ? static_cast<char *>(this->buffer.allocation.mapped) + offset
+                     : nullptr;
+  return slice;
+}
+
+void LinearArena::destroy() {
+  if (this->allocator != nullptr) this->allocator->destroyBuffer(this->buffer);
+  this->allocator = nullptr;
+  this->capacity = this->head = 0;
+}
@@ -0,0 +1,157 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef GPUALLOCATOR_H
+#define GPUALLOCATOR_H
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+//* buffers and linear images vs optimal images never share a block, which
+//* keeps every block trivially within bufferImageGranularity rules
+enum class ResourceKind { Linear, Optimal };
+
+struct GpuAllocation {
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  void* mapped = nullptr;  //? host visible blocks stay persistently mapped
+  uint32_t memoryType = 0;
+  uint32_t poolIndex = UINT32_MAX;  //? UINT32_MAX = dedicated vkAllocateMemory
+  uint32_t blockIndex = 0;
+};
+
+struct GpuBuffer {
+  VkBuffer buffer = VK_NULL_HANDLE;
+  GpuAllocation allocation;
+};
+
+struct GpuImage {
+  VkImage image = VK_NULL_HANDLE;
+  GpuAllocation allocation;
+};
+
+struct GpuAllocatorStats {
+  uint32_t deviceAllocations = 0;  //? live vkAllocateMemory calls (blocks + dedicated)
+  uint32_t subAllocations = 0;
+  VkDeviceSize bytesReserved = 0;  //? total size of device memory objects
+  VkDeviceSize bytesUsed = 0;      //? bytes handed out (rounded to buddy sizes)
+};
+
+//* power-of-two buddy allocator over one VkDeviceMemory, for long lived resources
+class BuddyBlock {
+ private:
+  static constexpr VkDeviceSize MIN_SIZE = 256;
+  VkDeviceSize size = 0;
+  uint32_t maxOrder = 0;
+  std::vector<std::set<VkDeviceSize>> freeLists;  //? [order] -> free offsets of MIN_SIZE << order
+  std::unordered_map<VkDeviceSize, uint32_t> usedOrders;  //? offset -> order
+  VkDeviceSize used = 0;
+
+ public:
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  void* mapped = nullptr;
+
+  explicit BuddyBlock(VkDeviceSize blockSize);
+  bool allocate(VkDeviceSize requestSize, VkDeviceSize alignment,
+                VkDeviceSize& offset, VkDeviceSize& allocatedSize);
+  void free(VkDeviceSize offset);
+  VkDeviceSize getUsed() const { return this->used; }
+  VkDeviceSize getSize() const { return this->size; }
+  size_t getAllocationCount() const { return this->usedOrders.size(); }
+};
+
+class GpuAllocator {
+ private:
+  struct Pool {
+    uint32_t memoryType = 0;
+    ResourceKind kind = ResourceKind::Linear;
+    VkDeviceSize blockSize = 0;
+    std::vector<std::unique_ptr<BuddyBlock>> blocks;  //? null slots are released blocks
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  VkPhysicalDeviceMemoryProperties memoryProperties = {};
+  VkDeviceSize bufferImageGranularity = 1;
+  uint32_t maxAllocationCount = 0;
+  VkDeviceSize preferredBlockSize = 0;
+  std::vector<Pool> pools;
+  GpuAllocatorStats stats;
+  mutable std::mutex mutex;
+
+  uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags required,
+                          VkMemoryPropertyFlags preferred) const;
+  Pool& getPool(uint32_t memoryType, ResourceKind kind);
+  VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryType,
+                                      void** mapped);
+  void freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, bool mapped);
+
+ public:
+  static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull << 20;
+
+  GpuAllocator() = default;
+  GpuAllocator(const GpuAllocator&) = delete;
+  GpuAllocator& operator=(const GpuAllocator&) = delete;
+
+  void init(VkPhysicalDevice physicalDevice, VkDevice logicalDevice,
+            VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+  GpuAllocation allocate(const VkMemoryRequirements& requirements,
+                         VkMemoryPropertyFlags required,
+                         VkMemoryPropertyFlags preferred, ResourceKind kind);
+  void free(GpuAllocation& allocation);
+
+  //? more than one sharedFamilies entry makes the buffer CONCURRENT across them
+  GpuBuffer createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
+                         VkMemoryPropertyFlags required,
+                         VkMemoryPropertyFlags preferred = 0,
+                         const std::vector<uint32_t>& sharedFamilies = {});
+  void destroyBuffer(GpuBuffer& buffer);
+  GpuImage createImage(const VkImageCreateInfo& imageCreateInfo,
+                       VkMemoryPropertyFlags required);
+  void destroyImage(GpuImage& image);
+
+  GpuAllocatorStats getStats() const;
+  VkDeviceSize getBufferImageGranularity() const {
+    return this->bufferImageGranularity;
+  }
+  void destroy();
+};
+
+//* bump allocator over one persistently mapped buffer, reset wholesale once
+//* the GPU is done with it (per frame data: uniforms, instance data, staging)
+struct BufferSlice {
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  void* mapped = nullptr;
+};
+
+class LinearArena {
+ private:
+  GpuAllocator* allocator = nullptr;
+  GpuBuffer buffer;
+  VkDeviceSize capacity = 0;
+  VkDeviceSize head = 0;
+  VkDeviceSize peak = 0;
+
+ public:
+  void init(GpuAllocator& gpuAllocator, VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            const std::vector<uint32_t>& sharedFamilies = {});
+  BufferSlice allocate(VkDeviceSize size, VkDeviceSize alignment);
+  void reset() { this->head = 0; }
+  VkDeviceSize getUsed() const { return this->head; }
+  VkDeviceSize getPeak() const { return this->peak; }
+  VkBuffer getBuffer() const { return this->buffer.buffer; }
+  void destroy();
+};
+
+#endif  // GPUALLOCATOR_H
@@ -0,0 +1,167 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "GpuCuller.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+void GpuCuller::init(VkDevice logicalDevice, GpuAllocator &gpuAllocator,
+                     DescriptorLayoutCache &layoutCache, VkPipelineCache cache,
+                     VkShaderModule cullShader,
+                     const std::vector<VkBuffer> &frameInputBuffers,
+                     const std::vector<uint32_t> &queueFamilies) {
+  this->device = logicalDevice;
+  this->allocator = &gpuAllocator;
+  this->frameInputs = frameInputBuffers;
+  this->sharedFamilies = queueFamilies;
+  this->asyncQueue = queueFamilies.size() > 1;
+  const auto frameCount = static_cast<uint32_t>(frameInputBuffers.size());
+
+  //* 0: frame input (transforms + jobs), 1: draw commands, 2: visible objects
+  std::vector<VkDescriptorSetLayoutBinding> bindings(3);
+  for (uint32_t i = 0; i < 3; i++) {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  }
+  this->setLayout = layoutCache.get(bindings);
+
+  VkPushConstantRange pushConstantRange = {};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+  pushConstantRange.size = sizeof(PushConstants);
+  VkPipelineLayoutCreateInfo layoutCreateInfo = {};
+  layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  layoutCreateInfo.setLayoutCount = 1;
+  layoutCreateInfo.pSetLayouts = &this->setLayout;
+  layoutCreateInfo.pushConstantRangeCount = 1;
+  layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+  if (vkCreatePipelineLayout(this->device, &layoutCreateInfo, nullptr,
+                             &this->pipelineLayout) != VK_SUCCESS)
+    throw std::runtime_error("failed to create cull pipeline layout");
+
+  VkComputePipelineCreateInfo pipelineCreateInfo = {};
+  pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  pipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  pipelineCreateInfo.stage.module = cullShader;
+  pipelineCreateInfo.stage.pName = "main";
+  pipelineCreateInfo.layout = this->pipelineLayout;
+  const VkResult result = vkCreateComputePipelines(
+      this->device, cache, 1, &pipelineCreateInfo, nullptr, &this->pipeline);
+  if (result != VK_SUCCESS)
+    throw std::runtime_error("failed to create cull pipeline");
+
+  this->frames.resize(frameCount);
+  for (uint32_t frame = 0; frame < frameCount; frame++)
+    this->reserve(frame, 1024, 16);
+}
+
+void GpuCuller::reserve(uint32_t frame, uint32_t objectCount,
+                        uint32_t jobCount) {
+  FrameResources &resources = this->frames[frame];
+  if (objectCount <= resources.visibleCapacity &&
+      jobCount <= resources.commandCapacity)
+    return;
+  //? grow geometrically, the frame's timeline wait guarantees the old buffers are idle
+  if (jobCount > resources.commandCapacity) {
+    this->allocator->destroyBuffer(resources.commands);
+    resources.commandCapacity = std::max(jobCount, resources.commandCapacity * 2);
+    resources.commands = this->allocator->createBuffer(
+        sizeof(VkDrawIndexedIndirectCommand) * resources.commandCapacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, this->sharedFamilies);
+  }
+  if (objectCount > resources.visibleCapacity) {
+    this->allocator->destroyBuffer(resources.visible);
+    resources.visibleCapacity =
+        std::max(objectCount, resources.visibleCapacity * 2);
+    resources.visible = this->allocator->createBuffer(
+        sizeof(uint32_t) * resources.visibleCapacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, this->sharedFamilies);
+  }
+}
+
+void GpuCuller::record(VkCommandBuffer commandBuffer, uint32_t frame,
+                       DescriptorAllocator &descriptors,
+                       VkDeviceSize jobOffset, uint32_t jobCount,
+                       uint32_t maxObjectCount, const float planes[6][4]) {
+  if (jobCount == 0) return;
+  const FrameResources &resources = this->frames[frame];
+
+  //? a fresh set every frame, buffers may have been regrown since the last one
+  const VkDescriptorSet descriptorSet =
+      descriptors.allocate(frame, this->setLayout);
+  VkDescriptorBufferInfo bufferInfos[3] = {};
+  bufferInfos[0].buffer = this->frameInputs[frame];
+  bufferInfos[0].range = VK_WHOLE_SIZE;
+  bufferInfos[1].buffer = resources.commands.buffer;
+  bufferInfos[1].range = VK_WHOLE_SIZE;
+  bufferInfos[2].buffer = resources.visible.buffer;
+  bufferInfos[2].range = VK_WHOLE_SIZE;
+  VkWriteDescriptorSet writes[3] = {};
+  for (uint32_t i = 0; i < 3; i++) {
+    writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[i].dstSet = descriptorSet;
+    writes[i].dstBinding = i;
+    writes[i].descriptorCount = 1;
+    writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[i].pBufferInfo = &bufferInfos[i];
+  }
+  vkUpdateDescriptorSets(this->device, 3, writes, 0, nullptr);
+
+  //# zero the commands, the shader fills in the rest and counts instances up
+  vkCmdFillBuffer(commandBuffer, resources.commands.buffer, 0,
+                  sizeof(VkDrawIndexedIndirectCommand) * jobCount, 0);
+  VkMemoryBarrier fillBarrier = {};
+  fillBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  fillBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  fillBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &fillBarrier,
+                       0, nullptr, 0, nullptr);
+
+  //# one row of workgroups per job
+  PushConstants pushConstants = {};
+  std::copy(&planes[0][0], &planes[0][0] + 24, &pushConstants.planes[0][0]);
+  pushConstants.jobBase = static_cast<uint32_t>(jobOffset / 16);
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, this->pipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          this->pipelineLayout, 0, 1, &descriptorSet,
+                          0, nullptr);
+  vkCmdPushConstants(commandBuffer, this->pipelineLayout,
+                     VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants),
+                     &pushConstants);
+  vkCmdDispatch(commandBuffer,
+                (maxObjectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+                jobCount, 1);
+
+  //# commands feed the indirect draws, the visible list the vertex shader.
+  //? across queues the graphics submit's semaphore wait does this instead
+  if (this->asyncQueue) return;
+  VkMemoryBarrier cullBarrier = {};
+  cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  cullBarrier.dstAccessMask =
+      VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                           VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                       0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+}
+
+void GpuCuller::destroy() {
+  if (this->device == VK_NULL_HANDLE) return;
+  for (auto &resources : this->frames) {
+    this->allocator->destroyBuffer(resources.commands);
+    this->allocator->destroyBuffer(resources.visible);
+  }
+  this->frames.clear();
+  vkDestroyPipeline(this->device, this->pipeline, nullptr);
+  vkDestroyPipelineLayout(this->device, this->pipelineLayout, nullptr);
+  this->device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,82 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef GPUCULLER_H
+#define GPUCULLER_H
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+#include "DescriptorAllocator.h"
+#include "GpuAllocator.h"
+
+//* one instance set to cull, every instance is one object. job i owns
+//* indirect command i
+//? mirrors the Job struct in cull.comp (std430, 32 bytes)
+struct CullJob {
+  float boundingSphere[4];  //? mesh space center xyz + radius
+  uint32_t objectCount;
+  uint32_t visibleBase;  //? first slot of the set in the visible object buffer
+  uint32_t transformBase;  //? first instance transform, in vec4 units of the frame buffer
+  uint32_t indexCount;
+};
+static_assert(sizeof(CullJob) == 32);
+
+//* GPU driven culling: a compute pass tests every object's bounding sphere
+//* against the frustum. survivors are appended to a compacted per-frame
+//* list of object indices, and each set keeps a single instanced indirect
+//* command whose instanceCount is bumped atomically. the vertex shader maps
+//* gl_InstanceIndex through that list to the object's transform and color
+class GpuCuller {
+ private:
+  static constexpr uint32_t WORKGROUP_SIZE = 64;  //? local_size_x of cull.comp
+  struct FrameResources {
+    GpuBuffer commands;  //? one VkDrawIndexedIndirectCommand per job
+    GpuBuffer visible;  //? uint object index per survivor, grouped by job
+    uint32_t commandCapacity = 0;
+    uint32_t visibleCapacity = 0;
+  };
+  struct PushConstants {
+    float planes[6][4];
+    uint32_t jobBase;  //? first job, in vec4 units of the frame buffer
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  GpuAllocator* allocator = nullptr;
+  VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;  //? owned by the layout cache
+  VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  std::vector<FrameResources> frames;
+  std::vector<VkBuffer> frameInputs;  //? per-frame host buffer holding transforms and jobs
+  std::vector<uint32_t> sharedFamilies;  //? compute + graphics when culling runs on its own queue
+  bool asyncQueue = false;  //? graphics waits on a semaphore, no in-queue barrier to the draws
+
+ public:
+  GpuCuller() = default;
+  GpuCuller(const GpuCuller&) = delete;
+  GpuCuller& operator=(const GpuCuller&) = delete;
+
+  void init(VkDevice logicalDevice, GpuAllocator& gpuAllocator,
+            DescriptorLayoutCache& layoutCache, VkPipelineCache cache,
+            VkShaderModule cullShader,  //? not owned, stays with the shader library
+            const std::vector<VkBuffer>& frameInputBuffers,
+            const std::vector<uint32_t>& queueFamilies = {});
+  //? grows the frame's buffers, only call once the frame's timeline value is reached
+  void reserve(uint32_t frame, uint32_t objectCount, uint32_t jobCount);
+  VkBuffer getCommandBuffer(uint32_t frame) const {
+    return this->frames[frame].commands.buffer;
+  }
+  VkBuffer getVisibleBuffer(uint32_t frame) const {
+    return this->frames[frame].visible.buffer;
+  }
+  //* records the cull dispatch, must be outside of a render pass. on an async
+  //* compute queue the graphics submit waits for it at the draw indirect stage
+  void record(VkCommandBuffer commandBuffer, uint32_t frame,
+              DescriptorAllocator& descriptors, VkDeviceSize jobOffset,
+              uint32_t jobCount, uint32_t maxObjectCount,
+              const float planes[6][4]);
+  void destroy();
+};
+
+#endif  // GPUCULLER_H
@@ -0,0 +1,232 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+void GpuProfiler::init(VkDevice logicalDevice, uint32_t framesInFlight,
+                       float timestampPeriod, uint32_t timestampValidBits) {
+  this->device = logicalDevice;
+  this->enabled = timestampValidBits > 0;
+  if (!this->enabled) return;
+  this->nsPerTick = static_cast<double>(timestampPeriod);
+  this->framesInFlight = framesInFlight;
+  this->createQueue("GPU", timestampValidBits);
+}
+
+uint32_t GpuProfiler::addQueue(const char *name, uint32_t timestampValidBits) {
+  if (!this->enabled) return UINT32_MAX;
+  this->createQueue(name, timestampValidBits);
+  return static_cast<uint32_t>(this->queues.size() - 1);
+}
+
+void GpuProfiler::createQueue(const char *name, uint32_t timestampValidBits) {
+  this->queues.emplace_back();
+  QueueQueries &queue = this->queues.back();
+  queue.name = name;
+  queue.timed = timestampValidBits > 0;
+  if (!queue.timed) return;
+  queue.tickMask = timestampValidBits >= 64 ? ~0ull
+                                            : (1ull << timestampValidBits) - 1;
+
+  VkQueryPoolCreateInfo poolCreateInfo = {};
+  poolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  poolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  poolCreateInfo.queryCount = MAX_SCOPES * 2;
+  queue.frames.resize(this->framesInFlight);
+  for (auto &queries : queue.frames) {
+    if (vkCreateQueryPool(this->device, &poolCreateInfo, nullptr,
+                          &queries.pool) != VK_SUCCESS)
+      throw std::runtime_error("failed to create timestamp query pool");
+  }
+}
+
+void GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t frame,
+                             uint32_t queue) {
+  if (!this->enabled || queue >= this->queues.size() ||
+      !this->queues[queue].timed)
+    return;
+  FrameQueries &queries = this->queues[queue].frames[frame];
+  if (queries.pending) this->collect(queue, queries);
+  //? reset on the GPU timeline, recorded before any scope of this frame
+  vkCmdResetQueryPool(commandBuffer, queries.pool, 0, MAX_SCOPES * 2);
+  queries.scopeCount = 0;
+  //? only the graphics queue advances the frame, the others run ahead of it
+  queries.frameIndex = queue == 0 ? this->frameIndex++ : this->frameIndex;
+  queries.pending = true;
+}
+
+uint32_t GpuProfiler::beginScope(VkCommandBuffer commandBuffer, uint32_t frame,
+                                 const char *name, uint32_t queue) {
+  if (!this->enabled || queue >= this->queues.size() ||
+      !this->queues[queue].timed)
+    return UINT32_MAX;
+  FrameQueries &queries = this->queues[queue].frames[frame];
+  if (queries.scopeCount == MAX_SCOPES) return UINT32_MAX;  //? dropped, not an error
+  const uint32_t scope = queries.scopeCount++;
+  queries.names[scope] = name;
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                      queries.pool, scope * 2);
+  return scope;
+}
+
+void GpuProfiler::endScope(VkCommandBuffer commandBuffer, uint32_t frame,
+                           uint32_t scope, uint32_t queue) {
+  if (!this->enabled || scope == UINT32_MAX) return;
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                      this->queues[queue].frames[frame].pool, scope * 2 + 1);
+}
+
+void GpuProfiler::collect(uint32_t queue, FrameQueries &queries) {
+  queries.pending = false;
+  if (queries.scopeCount == 0) return;
+  //* value + availability per query, no WAIT flag: the frame's timeline value already passed,
+  //* anything still unavailable (a scope that was never closed) is skipped
+  std::array<uint64_t, MAX_SCOPES * 4> results = {};
+  const VkResult result = vkGetQueryPoolResults(
+      this->device, queries.pool, 0, queries.scopeCount * 2,
+      sizeof(uint64_t) * 4 * queries.scopeCount, results.data(),
+      sizeof(uint64_t) * 2,
+      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+  if (result != VK_SUCCESS && result != VK_NOT_READY) return;
+  const uint64_t tickMask = this->queues[queue].tickMask;
+
+  for (uint32_t scope = 0; scope < queries.scopeCount; scope++) {
+    const uint64_t *begin = &results[scope * 4];
+    const uint64_t *end = &results[scope * 4 + 2];
+    if (begin[1] == 0 || end[1] == 0) continue;
+    const uint64_t beginTicks = begin[0] & tickMask;
+    const uint64_t endTicks = end[0] & tickMask;
+    if (!this->hasOrigin) {
+      this->originTicks = beginTicks;
+      this->hasOrigin = true;
+    }
+    //? masked subtraction survives a counter wrap
+    const uint64_t duration = (endTicks - beginTicks) & tickMask;
+    //? the origin may come from another queue whose work started later, so this can be negative
+    const uint64_t sinceOrigin = (beginTicks - this->originTicks) & tickMask;
+    const double signedSince =
+        sinceOrigin > (tickMask >> 1)
+            ? -static_cast<double>((tickMask - sinceOrigin) + 1)
+            : static_cast<double>(sinceOrigin);
+    this->addSample(queries.names[scope],
+                    static_cast<double>(duration) * this->nsPerTick / 1e6);
+
+    TraceEvent event = {};
+    event.name = queries.names[scope];
+    event.queue = queue;
+    event.frameIndex = queries.frameIndex;
+    event.startUs = signedSince * this->nsPerTick / 1e3;
+    event.durationUs = static_cast<double>(duration) * this->nsPerTick / 1e3;
+    if (this->trace.size() < MAX_TRACE_EVENTS) {
+      this->trace.push_back(event);
+    } else {
+      this->trace[this->traceNext] = event;
+      this->traceNext = (this->traceNext + 1) % MAX_TRACE_EVENTS;
+    }
+  }
+}
+
+void GpuProfiler::addSample(const char *name, double ms) {
+  auto pass = std::find_if(this->passes.begin(), this->passes.end(),
+                           [name](const PassStats &stats) {
+                             return stats.name == name;
+                           });
+  if (pass == this->passes.end()) {
+    this->passes.emplace_back();
+    pass = this->passes.end() - 1;
+    pass->name = name;
+  }
+  pass->samples[pass->next] = ms;
+  pass->next = (pass->next + 1) % HISTORY;
+  pass->count = std::min(pass->count + 1, HISTORY);
+}
+
+double GpuProfiler::getAverageMs(const std::string &pass) const {
+  for (const auto &stats : this->passes) {
+    if (stats.name != pass || stats.count == 0) continue;
+    double sum = 0.0;
+    for (size_t i = 0; i < stats.count; i++) sum += stats.samples[i];
+    return sum / static_cast<double>(stats.count);
+  }
+  return 0.0;
+}
+
+std::string GpuProfiler::formatTable() const {
+  std::string table = "GPU pass            last ms    avg ms    min ms    max ms\n";
+  char line[128];
+  for (const auto &stats : this->passes) {
+    if (stats.count == 0) continue;
+    double sum = 0.0;
+    double low = std::numeric_limits<double>::max();
+    double high = 0.0;
+    for (size_t i = 0; i < stats.count; i++) {
+      sum += stats.samples[i];
+      low = std::min(low, stats.samples[i]);
+      high = std::max(high, stats.samples[i]);
+    }
+    const double last = stats.samples[(stats.next + HISTORY - 1) % HISTORY];
+    std::snprintf(line, sizeof(line), "%-16s %9.3f %9.3f %9.3f %9.3f\n",
+                  stats.name.c_str(), last, sum / static_cast<double>(stats.count),
+                  low, high);
+    table += line;
+  }
+  for (const auto &queue : this->queues) {
+    if (queue.timed) continue;
+    std::snprintf(line, sizeof(line),
+                  "(%s queue: untimed, its family writes no timestamps)\n",
+                  queue.name);
+    table += line;
+  }
+  return table;
+}
+
+bool GpuProfiler::writeChromeTrace(const std::string &path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    std::cerr << "failed to open GPU trace " << path << std::endl;
+    return false;
+  }
+  //* Trace Event Format, complete ("X") events of process 1, one thread per queue
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  char line[256];
+  for (size_t queue = 0; queue < this->queues.size(); queue++) {
+    std::snprintf(line, sizeof(line),
+                  "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                  "\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                  queue == 0 ? "" : ",", queue + 1, this->queues[queue].name);
+    file << line;
+  }
+  for (size_t i = 0; i < this->trace.size(); i++) {
+    //? oldest first once the ring has wrapped
+    const TraceEvent &event = this->trace[(this->traceNext + i) % this->trace.size()];
+    std::snprintf(line, sizeof(line),
+                  ",\n{\"name\":\"%s\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,"
+                  "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+                  event.name, event.queue + 1, event.startUs, event.durationUs,
+                  static_cast<unsigned long long>(event.frameIndex));
+    file << line;
+  }
+  file << "\n]}\n";
+  file.close();
+  if (!file) {
+    std::cerr << "failed to write GPU trace " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void GpuProfiler::destroy() {
+  for (auto &queue : this->queues)
+    for (auto &queries : queue.frames)
+      if (queries.pool != VK_NULL_HANDLE)
+        vkDestroyQueryPool(this->device, queries.pool, nullptr);
+  this->queues.clear();
+  this->enabled = false;
+}
@@ -0,0 +1,98 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef GPUPROFILER_H
+#define GPUPROFILER_H
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//* GPU pass timings from timestamp queries. every frame in flight owns a
+//* query pool, scopes write a timestamp pair around a pass and the results
+//* are read back once the frame's timeline value is reached, so nothing stalls.
+//* keeps a rolling window per pass plus a bounded event list for Chrome traces.
+//* queue 0 is the graphics queue, other queues (async compute) get their own
+//* pools via addQueue and their own track in the trace
+class GpuProfiler {
+ private:
+  static constexpr uint32_t MAX_SCOPES = 32;  //? per frame, two queries each
+  static constexpr size_t HISTORY = 120;  //? frames in the rolling per-pass window
+  static constexpr size_t MAX_TRACE_EVENTS = 1u << 16;  //? oldest events are overwritten
+
+  struct FrameQueries {
+    VkQueryPool pool = VK_NULL_HANDLE;
+    std::array<const char*, MAX_SCOPES> names = {};  //? scope i uses queries 2i and 2i+1
+    uint32_t scopeCount = 0;
+    uint64_t frameIndex = 0;
+    bool pending = false;  //? recorded, results not read back yet
+  };
+  struct QueueQueries {
+    const char* name = nullptr;
+    uint64_t tickMask = ~0ull;  //? timestampValidBits of the queue family
+    bool timed = false;  //? false: the family writes no timestamps, scopes are dropped
+    std::vector<FrameQueries> frames;
+  };
+  struct PassStats {
+    std::string name;
+    std::array<double, HISTORY> samples = {};  //? ms, ring
+    size_t count = 0;
+    size_t next = 0;
+  };
+  struct TraceEvent {
+    const char* name = nullptr;
+    uint32_t queue = 0;
+    uint64_t frameIndex = 0;
+    double startUs = 0.0;
+    double durationUs = 0.0;
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  double nsPerTick = 1.0;  //? VkPhysicalDeviceLimits::timestampPeriod
+  bool enabled = false;
+  uint64_t frameIndex = 0;
+  uint64_t originTicks = 0;  //? first timestamp ever read, trace time zero
+  bool hasOrigin = false;
+  uint32_t framesInFlight = 0;
+  std::vector<QueueQueries> queues;
+  std::vector<PassStats> passes;
+  std::vector<TraceEvent> trace;  //? ring of MAX_TRACE_EVENTS once full
+  size_t traceNext = 0;
+
+  void createQueue(const char* name, uint32_t timestampValidBits);
+  void collect(uint32_t queue, FrameQueries& queries);
+  void addSample(const char* name, double ms);
+
+ public:
+  GpuProfiler() = default;
+  GpuProfiler(const GpuProfiler&) = delete;
+  GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+  //? timestampValidBits == 0 means the queue cannot write timestamps, the profiler stays off
+  void init(VkDevice logicalDevice, uint32_t framesInFlight,
+            float timestampPeriod, uint32_t timestampValidBits);
+  //? another queue to time, returns its id for the calls below. a family
+  //? without timestamps is kept as untimed and listed as such in formatTable
+  uint32_t addQueue(const char* name, uint32_t timestampValidBits);
+  bool isEnabled() const { return this->enabled; }
+  //! call right after vkBeginCommandBuffer, once the frame's timeline value is reached.
+  //! other queues begin their frame before the graphics queue of the same frame
+  void beginFrame(VkCommandBuffer commandBuffer, uint32_t frame,
+                  uint32_t queue = 0);
+  //? returns the scope id for endScope, name must outlive the profiler (a literal).
+  //! scopes must stay outside render passes that execute secondary command buffers
+  uint32_t beginScope(VkCommandBuffer commandBuffer, uint32_t frame,
+                      const char* name, uint32_t queue = 0);
+  void endScope(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t scope,
+                uint32_t queue = 0);
+  //? pass | last | avg | min | max in ms over the rolling window
+  std::string formatTable() const;
+  double getAverageMs(const std::string& pass) const;
+  bool writeChromeTrace(const std::string& path) const;
+  void destroy();
+};
+
+#endif  // GPUPROFILER_H
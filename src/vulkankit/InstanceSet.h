@@ -0,0 +1,61 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef INSTANCESET_H
+#define INSTANCESET_H
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "RenderVUtil.h"
+#include "VertexLayout.h"
+
+//* per-instance placement, applied after the mesh decode
+struct InstanceTransform {
+  float translation[3];
+  float scale;
+};
+
+//? each stream is its own instance-rate binding, so the vertex fetch only
+//? touches the bytes it needs and the CPU writes each array linearly
+using InstanceTransformLayout =
+    VertexLayout<VK_VERTEX_INPUT_RATE_INSTANCE, AttributeFloat4>;
+using InstanceColorLayout =
+    VertexLayout<VK_VERTEX_INPUT_RATE_INSTANCE, AttributeUnorm8x4>;
+static_assert(sizeof(InstanceTransform) == InstanceTransformLayout::stride);
+static_assert(sizeof(uint32_t) == InstanceColorLayout::stride);
+
+constexpr uint32_t INSTANCE_TRANSFORM_BINDING = 1;
+constexpr uint32_t INSTANCE_COLOR_BINDING = 2;
+
+//* one mesh drawn N times with a single instanced draw. the streams are
+//* structure of arrays, copied into the frame's mapped ring every frame
+struct InstanceSet {
+  Mesh mesh;
+  VkPipeline pipeline = VK_NULL_HANDLE;  //? null uses the default pipeline
+  uint32_t textureIndex = 0;  //? bindless slots, 0 is the white texture / default material
+  uint32_t materialIndex = 0;
+  std::vector<InstanceTransform> transforms;
+  std::vector<uint32_t> colors;  //? packed unorm8 rgba, r in the low byte
+
+  void add(float x, float y, float z, float scale, uint32_t color) {
+    this->transforms.push_back({{x, y, z}, scale});
+    this->colors.push_back(color);
+  }
+  void clear() {
+    this->transforms.clear();
+    this->colors.clear();
+  }
+  uint32_t size() const { return static_cast<uint32_t>(this->transforms.size()); }
+};
+
+inline uint32_t packColorUnorm8(float r, float g, float b, float a = 1.0f) {
+  return static_cast<uint32_t>(quantizeUnorm8(r)) |
+         static_cast<uint32_t>(quantizeUnorm8(g)) << 8 |
+         static_cast<uint32_t>(quantizeUnorm8(b)) << 16 |
+         static_cast<uint32_t>(quantizeUnorm8(a)) << 24;
+}
+
+#endif  // INSTANCESET_H
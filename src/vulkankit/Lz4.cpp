@@ -0,0 +1,130 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "Lz4.h"
+
+#include <cstring>
+
+namespace lz4 {
+namespace {
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;  //? a block always ends with at least 5 literals
+constexpr size_t MATCH_FIND_LIMIT = 12;  //? the last match starts at least 12 bytes before the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t HASH_BITS = 16;
+
+uint32_t read32(const uint8_t* bytes) {
+  uint32_t value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+uint32_t hashSequence(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+  //? continuation bytes after a saturated (15) nibble
+  while (length >= 255) {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+void emitSequence(std::vector<uint8_t>& out, const uint8_t* literals,
+                  size_t literalLength, size_t offset, size_t matchLength) {
+  const size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+  const uint8_t token = static_cast<uint8_t>(
+      ((literalLength < 15 ? literalLength : 15) << 4) |
+      (matchCode < 15 ? matchCode : 15));
+  out.push_back(token);
+  if (literalLength >= 15) writeLength(out, literalLength - 15);
+  out.insert(out.end(), literals, literals + literalLength);
+  if (matchLength == 0) return;  //? last sequence, literals only
+  out.push_back(static_cast<uint8_t>(offset & 0xff));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (matchCode >= 15) writeLength(out, matchCode - 15);
+}
+}  // namespace
+
+size_t compressBound(size_t size) { return size + size / 255 + 16; }
+
+void compress(const uint8_t* source, size_t size, std::vector<uint8_t>& out) {
+  out.clear();
+  out.reserve(compressBound(size));
+  size_t anchor = 0;
+  if (size >= MATCH_FIND_LIMIT + 1) {
+    //? positions are stored +1 so 0 means an empty slot
+    std::vector<uint32_t> table(size_t{1} << HASH_BITS, 0);
+    const size_t matchLimit = size - LAST_LITERALS;
+    size_t position = 0;
+    while (position + MATCH_FIND_LIMIT <= size) {
+      const uint32_t sequence = read32(source + position);
+      uint32_t& slot = table[hashSequence(sequence)];
+      const size_t candidate = slot;
+      slot = static_cast<uint32_t>(position + 1);
+      if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET ||
+          read32(source + candidate - 1) != sequence) {
+        position++;
+        continue;
+      }
+      const size_t match = candidate - 1;
+      size_t length = MIN_MATCH;
+      while (position + length < matchLimit &&
+             source[match + length] == source[position + length])
+        length++;
+      emitSequence(out, source + anchor, position - anchor, position - match, length);
+      position += length;
+      anchor = position;
+    }
+  }
+  emitSequence(out, source + anchor, size - anchor, 0, 0);
+}
+
+bool decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination,
+                size_t destinationSize) {
+  size_t in = 0;
+  size_t out = 0;
+  while (in < sourceSize) {
+    const uint8_t token = source[in++];
+    size_t literalLength = token >> 4;
+    if (literalLength == 15) {
+      uint8_t extra;
+      do {
+        if (in >= sourceSize) return false;
+        extra = source[in++];
+        literalLength += extra;
+      } while (extra == 255);
+    }
+    if (literalLength > sourceSize - in || literalLength > destinationSize - out)
+      return false;
+    if (literalLength > 0)
+      std::memcpy(destination + out, source + in, literalLength);
+    in += literalLength;
+    out += literalLength;
+    if (in == sourceSize) break;  //? the last sequence has no match part
+
+    if (sourceSize - in < 2) return false;
+    const size_t offset = source[in] | (static_cast<size_t>(source[in + 1]) << 8);
+    in += 2;
+    if (offset == 0 || offset > out) return false;
+    size_t matchLength = token & 15;
+    if (matchLength == 15) {
+      uint8_t extra;
+      do {
+        if (in >= sourceSize) return false;
+        extra = source[in++];
+        matchLength += extra;
+      } while (extra == 255);
+    }
+    matchLength += MIN_MATCH;
+    if (matchLength > destinationSize - out) return false;
+    //! byte by byte: a match may overlap the bytes it produces (runs)
+    const uint8_t* from = destination + out - offset;
+    for (size_t i = 0; i < matchLength; i++) destination[out + i] = from[i];
+    out += matchLength;
+  }
+  return out == destinationSize;
+}
+}  // namespace lz4
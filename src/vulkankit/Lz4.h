@@ -0,0 +1,24 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef LZ4_H
+#define LZ4_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//* LZ4 block format (no frame header, sizes are stored by the caller).
+//* the compressor is a single pass greedy matcher, it favours speed over ratio;
+//* the decompressor is bounds checked, a corrupt block fails instead of overrunning
+namespace lz4 {
+//? worst case output size for size input bytes
+size_t compressBound(size_t size);
+//? replaces out with the compressed block
+void compress(const uint8_t* source, size_t size, std::vector<uint8_t>& out);
+//? false when the block is malformed or does not expand to exactly destinationSize
+bool decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination,
+                size_t destinationSize);
+}  // namespace lz4
+
+#endif  // LZ4_H
@@ -0,0 +1,142 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+namespace {
+//? paths are UTF-8 like everywhere else, the W API wants UTF-16
+std::wstring widen(const std::string &path) {
+  const int count = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  if (count <= 0) return std::wstring();
+  std::wstring wide(static_cast<size_t>(count), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide[0], count);
+  wide.resize(static_cast<size_t>(count - 1));  //? drop the terminator
+  return wide;
+}
+}  // namespace
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : bytes(std::exchange(other.bytes, nullptr)),
+      length(std::exchange(other.length, 0)),
+      mapped(std::exchange(other.mapped, false)),
+      fallback(std::move(other.fallback)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    this->close();
+    this->bytes = std::exchange(other.bytes, nullptr);
+    this->length = std::exchange(other.length, 0);
+    this->mapped = std::exchange(other.mapped, false);
+    this->fallback = std::move(other.fallback);
+  }
+  return *this;
+}
+
+void MappedFile::open(const std::string &path) {
+  this->close();
+#ifndef _WIN32
+  const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) throw std::runtime_error("failed to open " + path);
+  struct stat info = {};
+  if (fstat(descriptor, &info) != 0) {
+    ::close(descriptor);
+    throw std::runtime_error("failed to stat " + path);
+  }
+  this->length = static_cast<size_t>(info.st_size);
+  if (this->length == 0) {
+    ::close(descriptor);
+    return;  //? mmap rejects empty ranges, an empty file is just empty
+  }
+  void *view = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  ::close(descriptor);  //? the mapping keeps its own reference to the file
+  if (view == MAP_FAILED) {
+    this->length = 0;
+    this->readWhole(path);  //? e.g. a filesystem without mmap support
+    return;
+  }
+  this->bytes = static_cast<const uint8_t *>(view);
+  this->mapped = true;
+#else
+  const HANDLE file = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("failed to open " + path);
+  LARGE_INTEGER size = {};
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    throw std::runtime_error("failed to get size of " + path);
+  }
+  this->length = static_cast<size_t>(size.QuadPart);
+  if (this->length == 0) {
+    CloseHandle(file);
+    return;  //? CreateFileMapping rejects empty files, an empty file is just empty
+  }
+  const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);  //? the mapping object keeps the file open
+  const void *view =
+      mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (mapping != nullptr) CloseHandle(mapping);  //? the view keeps the mapping alive
+  if (view == nullptr) {
+    this->length = 0;
+    this->readWhole(path);
+    return;
+  }
+  this->bytes = static_cast<const uint8_t *>(view);
+  this->mapped = true;
+#endif
+}
+
+void MappedFile::readWhole(const std::string &path) {
+  //* one read into word-aligned storage
+  FILE *file = std::fopen(path.c_str(), "rb");
+  if (!file) throw std::runtime_error("failed to open " + path);
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  std::fseek(file, 0, SEEK_SET);
+  if (size < 0) {
+    std::fclose(file);
+    throw std::runtime_error("failed to get size of " + path);
+  }
+  this->length = static_cast<size_t>(size);
+  this->fallback.resize((this->length + 3) / 4);
+  const size_t readSize = std::fread(this->fallback.data(), 1, this->length, file);
+  std::fclose(file);
+  if (readSize != this->length) {
+    this->close();
+    throw std::runtime_error("failed to read " + path);
+  }
+  this->bytes = reinterpret_cast<const uint8_t *>(this->fallback.data());
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+  if (this->mapped) UnmapViewOfFile(this->bytes);
+#else
+  if (this->mapped)
+    munmap(const_cast<uint8_t *>(this->bytes), this->length);
+#endif
+  this->bytes = nullptr;
+  this->length = 0;
+  this->mapped = false;
+  this->fallback.clear();
+}
@@ -0,0 +1,43 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//* read-only view of a whole file. mapped (mmap / MapViewOfFile), so reading
+//* costs page faults instead of a copy; only when mapping fails is the file
+//* read into a heap buffer. data() is page aligned when mapped, 4-byte
+//* aligned otherwise
+class MappedFile {
+ private:
+  const uint8_t* bytes = nullptr;
+  size_t length = 0;
+  bool mapped = false;
+  std::vector<uint32_t> fallback;  //? uint32_t storage keeps SPIR-V word alignment
+
+  void close();
+  //? the copy mapping was meant to avoid, only used when mapping fails
+  void readWhole(const std::string& path);
+
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path) { this->open(path); }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile() { this->close(); }
+
+  //? throws when the file cannot be opened or mapped
+  void open(const std::string& path);
+  const uint8_t* data() const { return this->bytes; }
+  size_t size() const { return this->length; }
+  bool isMapped() const { return this->mapped; }
+};
+
+#endif  // MAPPEDFILE_H
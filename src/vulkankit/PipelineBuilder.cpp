@@ -0,0 +1,226 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "PipelineBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+void PipelineBuilder::init(VkDevice logicalDevice, VkPipelineCache cache,
+                           ShaderModuleLoader shaderLoader,
+                           uint32_t threadCount) {
+  this->device = logicalDevice;
+  this->mainCache = cache;
+  this->loadShader = std::move(shaderLoader);
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  //? seed each worker with what the main cache already knows (warm start)
+  std::vector<char> seed;
+  size_t seedSize = 0;
+  if (this->mainCache != VK_NULL_HANDLE &&
+      vkGetPipelineCacheData(this->device, this->mainCache, &seedSize,
+                             nullptr) == VK_SUCCESS &&
+      seedSize > 0) {
+    seed.resize(seedSize);
+    if (vkGetPipelineCacheData(this->device, this->mainCache, &seedSize,
+                               seed.data()) != VK_SUCCESS)
+      seed.clear();
+  }
+  VkPipelineCacheCreateInfo cacheCreateInfo = {};
+  cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  cacheCreateInfo.initialDataSize = seed.size();
+  cacheCreateInfo.pInitialData = seed.empty() ? nullptr : seed.data();
+  this->workerCaches.resize(threadCount, VK_NULL_HANDLE);
+  for (auto &workerCache : this->workerCaches) {
+    if (vkCreatePipelineCache(this->device, &cacheCreateInfo, nullptr,
+                              &workerCache) != VK_SUCCESS) {
+      throw std::runtime_error("failed to create worker pipeline cache");
+    }
+  }
+  this->workers.start(threadCount);
+}
+
+std::shared_future<VkPipeline> PipelineBuilder::build(
+    const GraphicsPipelineDesc &desc) {
+  std::shared_future<VkPipeline> future =
+      this->workers
+          .submit([this, desc](uint32_t workerIndex) {
+            return this->createPipeline(desc, this->workerCaches[workerIndex]);
+          })
+          .share();
+  std::lock_guard<std::mutex> lock(this->pendingMutex);
+  this->pending.push_back(future);
+  return future;
+}
+
+std::vector<std::shared_future<VkPipeline>> PipelineBuilder::build(
+    const std::vector<GraphicsPipelineDesc> &descs) {
+  std::vector<std::shared_future<VkPipeline>> futures;
+  futures.reserve(descs.size());
+  for (const auto &desc : descs) futures.push_back(this->build(desc));
+  return futures;
+}
+
+void PipelineBuilder::finish() {
+  std::vector<std::shared_future<VkPipeline>> outstanding;
+  {
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
+    outstanding.swap(this->pending);
+  }
+  //? workers must be idle before their caches are read by the merge
+  for (const auto &future : outstanding) future.wait();
+  if (this->mainCache == VK_NULL_HANDLE || this->workerCaches.empty()) return;
+  if (vkMergePipelineCaches(this->device, this->mainCache,
+                            static_cast<uint32_t>(this->workerCaches.size()),
+                            this->workerCaches.data()) != VK_SUCCESS) {
+    throw std::runtime_error("failed to merge worker pipeline caches");
+  }
+}
+
+void PipelineBuilder::destroy() {
+  this->workers.stop();
+  for (auto workerCache : this->workerCaches)
+    vkDestroyPipelineCache(this->device, workerCache, nullptr);
+  this->workerCaches.clear();
+  this->pending.clear();
+}
+
+VkPipeline PipelineBuilder::createPipeline(const GraphicsPipelineDesc &desc,
+                                           VkPipelineCache cache) const {
+  //? Create Shader Module
+  //? modules are shared between pipelines, the loader owns them
+  const auto vertexShaderModule = this->loadShader(desc.vertexShader);
+  const auto fragmentShaderModule = this->loadShader(desc.fragmentShader);
+
+  //# SPECIALIZATION CONSTANTS (folded by the driver, one pipeline per variant)
+  const ShaderSpecialization &specialization = desc.specialization;
+  VkSpecializationInfo specializationInfo = {};
+  specializationInfo.mapEntryCount = static_cast<uint32_t>(specialization.entries.size());
+  specializationInfo.pMapEntries = specialization.entries.data();
+  specializationInfo.dataSize = specialization.data.size() * sizeof(uint32_t);
+  specializationInfo.pData = specialization.data.data();
+  const VkSpecializationInfo *stageSpecialization =
+      specialization.entries.empty() ? nullptr : &specializationInfo;
+
+  //# VERTEX SHADER STAGE CREATION INFO
+  VkPipelineShaderStageCreateInfo vertexShaderStageCreateInfo = {};
+  vertexShaderStageCreateInfo.sType =VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  vertexShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+  vertexShaderStageCreateInfo.module = vertexShaderModule;
+  vertexShaderStageCreateInfo.pName ="main";  // target function from where to start
+  vertexShaderStageCreateInfo.pSpecializationInfo = stageSpecialization;
+
+  //# FRAGMENT SHADER STAGE CREATION INFO
+  VkPipelineShaderStageCreateInfo fragmentShaderStageCreateInfo = {};
+  fragmentShaderStageCreateInfo.sType =VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  fragmentShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+  fragmentShaderStageCreateInfo.module = fragmentShaderModule;
+  fragmentShaderStageCreateInfo.pName ="main";  // target function from where to start
+  fragmentShaderStageCreateInfo.pSpecializationInfo = stageSpecialization;
+
+  VkPipelineShaderStageCreateInfo shaderStages[] = {
+    vertexShaderStageCreateInfo,
+    fragmentShaderStageCreateInfo
+};
+  //# Create GRAPHICS PIPELINE
+
+
+
+  //# Vertex Input (put in vertex description)
+  VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo = {};
+  vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  vertexInputCreateInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(desc.vertexBindings.size());
+  vertexInputCreateInfo.pVertexBindingDescriptions = desc.vertexBindings.data(); // * List of vertex Binding Description (data spacing and stride info)
+  vertexInputCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.vertexAttributes.size());
+  vertexInputCreateInfo.pVertexAttributeDescriptions = desc.vertexAttributes.data();  // * List of vertex Attribiute Description
+
+  //# INPUT ASSEMBLY
+  VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo = {};
+  inputAssemblyCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  inputAssemblyCreateInfo.topology = desc.topology; // * how vertices or point will be assembled
+  inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE; //* we're telling vulkan that stop drawing current shape, just start a new one
+
+  //# VIEWPORT & SCISSOR (dynamic, only the counts are baked in)
+  VkPipelineViewportStateCreateInfo viewportStateCreateInfo = {};
+  viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  viewportStateCreateInfo.viewportCount = 1;
+  viewportStateCreateInfo.pViewports = nullptr;
+  viewportStateCreateInfo.scissorCount = 1;
+  viewportStateCreateInfo.pScissors = nullptr;
+
+  //# DYNAMIC STATE (set at record time so the pipeline survives swapchain resizes)
+  const std::array<VkDynamicState,2> dynamicStates = {
+    VK_DYNAMIC_STATE_VIEWPORT,
+    VK_DYNAMIC_STATE_SCISSOR
+  };
+  VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo = {};
+  dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  dynamicStateCreateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+  dynamicStateCreateInfo.pDynamicStates = dynamicStates.data();
+
+  //# RASTERIZER
+  VkPipelineRasterizationStateCreateInfo  rasterizerCreateInfo = {};
+  rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  rasterizerCreateInfo.depthClampEnable = VK_FALSE; //* controls near and far planes of the viewport, know as depth clipping.
+  rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+  rasterizerCreateInfo.polygonMode = desc.polygonMode; //* how to paint the surface of the polygon. we can use VK_POLYGON_MODE_FILL for wireframe effect. But we need GPU feature
+  rasterizerCreateInfo.lineWidth = 1.0f; //* how thick the line should be.other than 1.0 we need GPU feature
+  rasterizerCreateInfo.cullMode = desc.cullMode; //* which face to cull/skip
+  rasterizerCreateInfo.frontFace = desc.frontFace; //* Winding to determine which side is front
+  rasterizerCreateInfo.depthBiasClamp = VK_FALSE; //* whether to add depth bias to fragment (require for shadow mapping)
+
+  //# MULTISAMPLING
+  VkPipelineMultisampleStateCreateInfo multisampleCreateInfo = {};
+  multisampleCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  multisampleCreateInfo.sampleShadingEnable = VK_FALSE; //!Currently we're disabling multisampling
+  multisampleCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+  //# Blending (how to blend multiple color in fragment)
+
+  VkPipelineColorBlendAttachmentState colorBlendAttachmentState = {};
+  colorBlendAttachmentState.colorWriteMask =  VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |  VK_COLOR_COMPONENT_B_BIT |  VK_COLOR_COMPONENT_A_BIT;
+  colorBlendAttachmentState.blendEnable = desc.blendEnable ? VK_TRUE : VK_FALSE; // Enable Color Blending
+  //* Blend Equation: (VK_BLEND_FACTOR_SRC_ALPHA * newColor) + (VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA * oldColor)
+  colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+  colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+  colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+  colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+  colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+
+  VkPipelineColorBlendStateCreateInfo colorBlendCreateInfo = {};
+  colorBlendCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+  colorBlendCreateInfo.logicOpEnable = VK_FALSE; //? AAlternative to calculation is to use logic operation
+  colorBlendCreateInfo.attachmentCount = 1;
+  colorBlendCreateInfo.pAttachments = &colorBlendAttachmentState;
+
+  //TODO: SETUP DEPTH & STENCIL TESTING
+  VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {};
+  graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  graphicsPipelineCreateInfo.stageCount = 2; //? number of shader stages
+  graphicsPipelineCreateInfo.pStages = shaderStages; //? shaders
+  graphicsPipelineCreateInfo.pVertexInputState = &vertexInputCreateInfo;
+  graphicsPipelineCreateInfo.pInputAssemblyState = &inputAssemblyCreateInfo;
+  graphicsPipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+  graphicsPipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+  graphicsPipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+  graphicsPipelineCreateInfo.pMultisampleState = &multisampleCreateInfo;
+  graphicsPipelineCreateInfo.pColorBlendState = &colorBlendCreateInfo;
+  graphicsPipelineCreateInfo.pDepthStencilState = nullptr;
+  graphicsPipelineCreateInfo.layout = desc.layout; //?pipeline layout
+  graphicsPipelineCreateInfo.renderPass = desc.renderPass; //?render pass description
+  graphicsPipelineCreateInfo.subpass = desc.subpass;
+  //* PIPELINE DERIVATIVES TO CREATE MULTIPLE PIPELINE THAT DERIVE FROM ONE ANOTHER FOR OPTIMIZATION
+  graphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+  graphicsPipelineCreateInfo.basePipelineIndex = -1;
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  const VkResult result = vkCreateGraphicsPipelines(this->device,cache,1,&graphicsPipelineCreateInfo,nullptr,&pipeline);
+
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("failed to create graphics pipeline");
+  }
+  return pipeline;
+}
@@ -0,0 +1,69 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef PIPELINEBUILDER_H
+#define PIPELINEBUILDER_H
+#include <vulkan/vulkan.h>
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ShaderVariant.h"
+#include "ThreadPool.h"
+
+//* everything that makes one graphics pipeline variant different from another
+struct GraphicsPipelineDesc {
+  std::string vertexShader;    //? SPIR-V path, relative to the asset root
+  std::string fragmentShader;  //? SPIR-V path, relative to the asset root
+  std::vector<VkVertexInputBindingDescription> vertexBindings;
+  std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+  VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+  VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+  VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+  VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+  bool blendEnable = true;
+  //? specialization constants for both stages, ids a stage does not declare are ignored
+  ShaderSpecialization specialization;
+  VkPipelineLayout layout = VK_NULL_HANDLE;
+  VkRenderPass renderPass = VK_NULL_HANDLE;
+  uint32_t subpass = 0;
+};
+
+//? returns a module the loader keeps ownership of, the builder never destroys it
+using ShaderModuleLoader = std::function<VkShaderModule(const std::string&)>;
+
+//* compiles pipeline batches on a worker pool. every worker owns a
+//* VkPipelineCache (caches are externally synchronized), they are folded
+//* back into the main cache with vkMergePipelineCaches in finish()
+class PipelineBuilder {
+ private:
+  VkDevice device = VK_NULL_HANDLE;
+  VkPipelineCache mainCache = VK_NULL_HANDLE;
+  ShaderModuleLoader loadShader;
+  ThreadPool workers;
+  std::vector<VkPipelineCache> workerCaches;
+  std::vector<std::shared_future<VkPipeline>> pending;  //? waited on by finish()
+  std::mutex pendingMutex;
+
+  VkPipeline createPipeline(const GraphicsPipelineDesc& desc,
+                            VkPipelineCache cache) const;
+
+ public:
+  PipelineBuilder() = default;
+  PipelineBuilder(const PipelineBuilder&) = delete;
+  PipelineBuilder& operator=(const PipelineBuilder&) = delete;
+
+  void init(VkDevice logicalDevice, VkPipelineCache cache,
+            ShaderModuleLoader shaderLoader, uint32_t threadCount);
+  std::shared_future<VkPipeline> build(const GraphicsPipelineDesc& desc);
+  std::vector<std::shared_future<VkPipeline>> build(
+      const std::vector<GraphicsPipelineDesc>& descs);
+  void finish();
+  void destroy();
+};
+
+#endif  // PIPELINEBUILDER_H
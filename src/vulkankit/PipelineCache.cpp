@@ -0,0 +1,107 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "PipelineCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+std::vector<char> PipelineCache::readBlob(const std::string &path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) return {};  //? no cache yet, first (cold) run
+  const auto size = static_cast<size_t>(file.tellg());
+  std::vector<char> blob(size);
+  file.seekg(0);
+  if (!file.read(blob.data(), static_cast<std::streamsize>(size))) return {};
+  return blob;
+}
+
+bool PipelineCache::isCompatible(const std::vector<char> &blob,
+                                 const VkPhysicalDeviceProperties &properties) {
+  //? a blob from another GPU or driver build is useless (and drivers may choke on it)
+  VkPipelineCacheHeaderVersionOne header = {};
+  if (blob.size() < sizeof(header)) return false;
+  std::memcpy(&header, blob.data(), sizeof(header));
+  return header.headerSize >= sizeof(header) &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == properties.vendorID &&
+         header.deviceID == properties.deviceID &&
+         std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID,
+                     VK_UUID_SIZE) == 0;
+}
+
+void PipelineCache::init(VkDevice logicalDevice,
+                         const VkPhysicalDeviceProperties &properties,
+                         const std::string &path) {
+  this->device = logicalDevice;
+  this->filePath = path;
+
+  std::vector<char> blob;
+  if (!this->filePath.empty()) {
+    blob = readBlob(this->filePath);
+    if (!blob.empty() && !isCompatible(blob, properties)) {
+      std::cerr << "Pipeline cache " << this->filePath
+                << " belongs to another device/driver, starting cold\n";
+      blob.clear();
+    }
+  }
+
+  VkPipelineCacheCreateInfo cacheCreateInfo = {};
+  cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  cacheCreateInfo.initialDataSize = blob.size();
+  cacheCreateInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+  if (vkCreatePipelineCache(this->device, &cacheCreateInfo, nullptr,
+                            &this->cache) == VK_SUCCESS) {
+    this->warm = !blob.empty();
+    return;
+  }
+  //? driver rejected the blob anyway, fall back to an empty cache
+  cacheCreateInfo.initialDataSize = 0;
+  cacheCreateInfo.pInitialData = nullptr;
+  if (vkCreatePipelineCache(this->device, &cacheCreateInfo, nullptr,
+                            &this->cache) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create pipeline cache");
+  }
+  this->warm = false;
+}
+
+void PipelineCache::save() const {
+  if (this->cache == VK_NULL_HANDLE || this->filePath.empty()) return;
+  size_t size = 0;
+  if (vkGetPipelineCacheData(this->device, this->cache, &size, nullptr) !=
+          VK_SUCCESS ||
+      size == 0)
+    return;
+  std::vector<char> blob(size);
+  if (vkGetPipelineCacheData(this->device, this->cache, &size, blob.data()) !=
+      VK_SUCCESS)
+    return;
+
+  //! write next to the target and rename over it, a crash never leaves a torn cache
+  const std::string tmpPath = this->filePath + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    file.write(blob.data(), static_cast<std::streamsize>(size));
+    file.close();
+    if (!file) {
+      std::cerr << "failed to write pipeline cache " << tmpPath << std::endl;
+      return;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(tmpPath, this->filePath, error);
+  if (error) {
+    std::cerr << "failed to save pipeline cache: " << error.message()
+              << std::endl;
+    std::filesystem::remove(tmpPath, error);
+  }
+}
+
+void PipelineCache::destroy() {
+  if (this->cache != VK_NULL_HANDLE)
+    vkDestroyPipelineCache(this->device, this->cache, nullptr);
+  this->cache = VK_NULL_HANDLE;
+}
@@ -0,0 +1,37 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef PIPELINECACHE_H
+#define PIPELINECACHE_H
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+//* VkPipelineCache that is loaded from / saved to disk between runs
+class PipelineCache {
+ private:
+  VkDevice device = VK_NULL_HANDLE;
+  VkPipelineCache cache = VK_NULL_HANDLE;
+  std::string filePath;
+  bool warm = false;  //? true when a valid blob was loaded from disk
+
+  static std::vector<char> readBlob(const std::string& path);
+  static bool isCompatible(const std::vector<char>& blob,
+                           const VkPhysicalDeviceProperties& properties);
+
+ public:
+  PipelineCache() = default;
+  PipelineCache(const PipelineCache&) = delete;
+  PipelineCache& operator=(const PipelineCache&) = delete;
+
+  void init(VkDevice logicalDevice, const VkPhysicalDeviceProperties& properties,
+            const std::string& path);
+  void save() const;
+  void destroy();
+  VkPipelineCache get() const { return this->cache; }
+  bool isWarm() const { return this->warm; }
+};
+
+#endif  // PIPELINECACHE_H
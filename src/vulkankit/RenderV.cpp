@@ -7,14 +7,30 @@
 #include <GLFW/glfw3.h>
 #include <assert.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <stdexcept>
 #include <vector>
 
+#ifndef VKGUIDE_SHADER_DIR
+#define VKGUIDE_SHADER_DIR "src/shader/"  //? CMake points this at the compiled shaders
+#endif
+#define VKGUIDE_ASSET_ARCHIVE VKGUIDE_SHADER_DIR "shaders.vkpa"  //? written by vkPack at build time
+#ifndef VKGUIDE_SHADER_SOURCE_DIR
+#define VKGUIDE_SHADER_SOURCE_DIR "src/shader/"  //? GLSL watched by shader hot reload
+#endif
+#ifndef VKGUIDE_GLSLC
+#define VKGUIDE_GLSLC "glslc"
+#endif
+
 VkApplicationInfo RenderV::getAppInfo(std::string appName,
                                       std::string engineName) {
   VkApplicationInfo appInfo = {};
@@ -68,10 +84,29 @@ QueueFamilyIndices RenderV::getQueueFamilies(VkPhysicalDevice &device) {
                                            queueFamilyList.data());
   for (uint8_t i = 0; i < queueFamilyList.capacity(); i++) {
     const auto queueFamily = queueFamilyList[i];
+    if (queueFamily.queueCount < 1) continue;
+    if (!Indices.isValidComputeFamily() &&
+        (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT))
+      Indices.computeFamily = i;
+    //? a compute family without graphics feeds the async compute engine
+    if (!Indices.isValidAsyncComputeFamily() &&
+        (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+        !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+      Indices.asyncComputeFamily = i;
+    //? a transfer-only family is usually the DMA engine, prefer it for uploads
+    if (!Indices.isValidTransferFamily() &&
+        (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+        !(queueFamily.queueFlags &
+          (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+      Indices.transferFamily = i;
     //? checking if queue family has at least one queue then checking if  first
     // byte of queueFlags binary is 1 using bit manipulation
-    if (queueFamily.queueCount > 0 &&
+    if (!Indices.isValidGraphicsFamily() &&
         queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+      Indices.graphicsFamily = i;
+      if (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) Indices.computeFamily = i;
+      //? headless mode has no surface, so there is nothing to present to
+      if (this->surface == VK_NULL_HANDLE) continue;
       VkBool32 does_support_presentation = VK_FALSE;
       vkGetPhysicalDeviceSurfaceSupportKHR(device, i, this->surface,
                                            &does_support_presentation);
@@ -80,11 +115,11 @@ QueueFamilyIndices RenderV::getQueueFamilies(VkPhysicalDevice &device) {
         throw std::runtime_error("Queue family does not support presentation!");
       }
       Indices.presentFamily = i;
-      Indices.graphicsFamily = i;
-      if (Indices.isValidGraphicsFamily() && Indices.isValidPresentFamily())
-        break;
     }
   }
+  //? graphics queues always support transfers, use it when there is no DMA queue
+  if (!Indices.isValidTransferFamily())
+    Indices.transferFamily = Indices.graphicsFamily;
 
   return Indices;
 }
@@ -93,6 +128,7 @@ QueueFamilyIndices RenderV::getQueueFamilies(VkPhysicalDevice &device) {
 bool RenderV::checkDeviceSuitability(VkPhysicalDevice physicalDevice) {
   auto indecies = this->getQueueFamilies(physicalDevice);
   if (!this->checkDeviceExtensionSupport(physicalDevice)) return false;
+  if (this->config.headless) return indecies.isValidGraphicsFamily();
   const SwapChainInfo swapChainInfo = this->getSwapChainInfo(physicalDevice);
   return indecies.isValidGraphicsFamily() &&
          !swapChainInfo.presentationModes.empty() &&
@@ -108,7 +144,7 @@ bool RenderV::checkDeviceExtensionSupport(VkPhysicalDevice &device) {
       std::vector<VkExtensionProperties>(ext_count);
   vkEnumerateDeviceExtensionProperties(device, nullptr, &ext_count,
                                        extensionHolder.data());
-  for (const auto &ext : this->deviceExtensions) {
+  for (const auto &ext : this->getDeviceExtensions()) {
     auto found = false;
     for (const auto &available_ext : extensionHolder) {
       if (strcmp(available_ext.extensionName, ext) == 0) {
@@ -128,16 +164,37 @@ void RenderV::checkPhysicalDeviceInfo(VkPhysicalDevice &device) {
   std::cout << "Device Type: " << properties.deviceType << std::endl;
   std::cout << "Driver Version: " << properties.driverVersion << std::endl;
   std::cout << "Vendor ID: " << properties.vendorID << std::endl;
+  std::cout << "Timestamp Period: " << properties.limits.timestampPeriod << " ns" << std::endl;
+}
+
+bool RenderV::hasDeviceExtension(VkPhysicalDevice device, const char *name) {
+  uint32_t count = 0;
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr);
+  std::vector<VkExtensionProperties> available(count);
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &count, available.data());
+  for (const auto &extension : available)
+    if (strcmp(extension.extensionName, name) == 0) return true;
+  return false;
+}
+
+std::vector<const char *> RenderV::getDeviceExtensions() const {
+  //? headless rendering never presents, so the swapchain extension is optional
+  if (this->config.headless) return {};
+  return this->deviceExtensions;
 }
 
 void RenderV::createVulkanInstance() {
+  CPU_ZONE("createVulkanInstance");
   // extensions count instance
   uint32_t extensionCount = 0;
-  const char **extensions = glfwGetRequiredInstanceExtensions(
-      &extensionCount);  // If Vulkan is not available on the machine, this
-                         // function returns NULL
-  if (extensions == nullptr)
-    throw std::runtime_error("GLFW API Unavailable Error");
+  const char **extensions = nullptr;
+  if (!this->config.headless) {
+    extensions = glfwGetRequiredInstanceExtensions(
+        &extensionCount);  // If Vulkan is not available on the machine, this
+                           // function returns NULL
+    if (extensions == nullptr)
+      throw std::runtime_error("GLFW API Unavailable Error");
+  }
   // Info about Application
   VkApplicationInfo appInfo = this->getAppInfo("Hello Vulkan", "n/a");
   // Info about Vulkan Instance
@@ -145,8 +202,9 @@ void RenderV::createVulkanInstance() {
   vk_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
   vk_info.pApplicationInfo = &appInfo;
 
-  std::vector<const char *> extension_list(extensions,
-                                           extensions + extensionCount);
+  std::vector<const char *> extension_list;
+  if (extensions != nullptr)
+    extension_list.assign(extensions, extensions + extensionCount);
   extension_list.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
   // check all extension if supported
@@ -175,7 +233,8 @@ void RenderV::createSurface() {
   }
 }
 
-void RenderV::createSwapChain() {
+void RenderV::createSwapChain(VkSwapchainKHR oldSwapChain) {
+  CPU_ZONE("createSwapChain");
   // getting swapchain info from device
   SwapChainInfo swapChainInfo =
       getSwapChainInfo(this->Context.Device.physicalDevice);
@@ -235,7 +294,7 @@ void RenderV::createSwapChain() {
   }
   //! if we have old swapChain then we will pass it it to oldSwapChain, which is
   //! mainly used when resizing screen
-  swapChainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+  swapChainCreateInfo.oldSwapchain = oldSwapChain;
 
   //* create swapchain
   if (vkCreateSwapchainKHR(this->Context.Device.logicalDevice,
@@ -257,6 +316,7 @@ void RenderV::createSwapChain() {
   vkGetSwapchainImagesKHR(this->Context.Device.logicalDevice, this->swapChain,
                           &swapChainImageCount, imageList.data());
   assert(!imageList.empty());
+  this->swapChainImages.clear();
   for (const auto image : imageList) {
     SwapChainImage swapChainImage = {};
     swapChainImage.image = image;
@@ -266,6 +326,171 @@ void RenderV::createSwapChain() {
   }
 }
 
+bool RenderV::recreateSwapChain() {
+  CPU_ZONE("recreateSwapChain");
+  const auto start = std::chrono::steady_clock::now();
+  if (!this->config.headless) {
+    VkSurfaceCapabilitiesKHR capabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(this->Context.Device.physicalDevice,
+                                              this->surface, &capabilities);
+    const VkExtent2D extent = this->chooseSwapExt(capabilities);
+    //? minimized window: nothing to render into, try again next frame
+    if (extent.width == 0 || extent.height == 0) return false;
+  }
+
+  //* park everything that depends on the old extent until in-flight frames are done with it
+  RetiredSwapChain retired = {};
+  retired.swapChain = this->swapChain;
+  retired.images = std::move(this->swapChainImages);
+  retired.frameBuffers = std::move(this->swapChainFrameBuffers);
+  retired.offscreenImages = std::move(this->offscreenImages);
+  retired.retiredAtFrame = this->frameCounter;
+  this->retiredSwapChains.push_back(std::move(retired));
+  this->swapChainImages.clear();
+  this->swapChainFrameBuffers.clear();
+  this->offscreenImages.clear();
+
+  //* render pass, pipeline, command buffers and sync objects survive,
+  //* viewport/scissor are dynamic and commands are recorded every frame
+  if (this->config.headless)
+    this->createOffscreenTargets();  //? follows config.headlessExtent
+  else
+    this->createSwapChain(this->retiredSwapChains.back().swapChain);
+  this->createFrameBuffers();
+  this->swapChainOutOfDate = false;
+
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  this->lastSwapChainRecreateMs = elapsed.count();
+  return true;
+}
+
+void RenderV::destroyRetiredSwapChains(bool force) {
+  const auto device = this->Context.Device.logicalDevice;
+  auto it = this->retiredSwapChains.begin();
+  while (it != this->retiredSwapChains.end()) {
+    //? every frame slot has been waited on since retirement -> GPU no longer uses it
+    if (!force &&
+        this->frameCounter < it->retiredAtFrame + this->config.framesInFlight) {
+      ++it;
+      continue;
+    }
+    for (auto framebuffer : it->frameBuffers)
+      vkDestroyFramebuffer(device, framebuffer, nullptr);
+    for (const auto &img : it->images)
+      vkDestroyImageView(device, img.imageView, nullptr);
+    for (auto &image : it->offscreenImages) this->allocator.destroyImage(image);
+    if (it->swapChain != VK_NULL_HANDLE)
+      vkDestroySwapchainKHR(device, it->swapChain, nullptr);
+    it = this->retiredSwapChains.erase(it);
+  }
+}
+
+void RenderV::applyShaderReloads() {
+  if (!this->shaderWatcher.isRunning() && this->pendingReloads.empty()) return;
+  CPU_ZONE("applyShaderReloads");
+  //# queue a rebuild of every pipeline that uses a recompiled shader
+  for (const auto &name : this->shaderWatcher.takeChanged()) {
+    this->shaderLibrary.reload(name);
+    const std::string changed = this->shaderLibrary.resolve(name);
+    const auto uses = [&](const GraphicsPipelineDesc &desc) {
+      return this->shaderLibrary.resolve(desc.vertexShader) == changed ||
+             this->shaderLibrary.resolve(desc.fragmentShader) == changed;
+    };
+    //? the built-in pipeline is one of the variants, it is rebuilt like the others
+    for (size_t i = 0; i < this->pipelineVariantDescs.size(); i++) {
+      if (!uses(this->pipelineVariantDescs[i])) continue;
+      for (auto &pending : this->pendingReloads)
+        if (pending.target == i) pending.superseded = true;
+      //? same builder + pipeline cache as startup, unchanged stages hit the cache
+      this->pendingReloads.push_back(
+          {i, this->pipelineBuilder.build(this->pipelineVariantDescs[i]), false});
+    }
+  }
+
+  //# swap in whatever finished compiling, never wait on the workers here
+  auto it = this->pendingReloads.begin();
+  while (it != this->pendingReloads.end()) {
+    if (it->pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    VkPipeline rebuilt = VK_NULL_HANDLE;
+    try {
+      rebuilt = it->pipeline.get();
+    } catch (const std::exception &e) {
+      std::cerr << "shader reload failed: " << e.what() << std::endl;  //? the old pipeline stays
+    }
+    if (rebuilt != VK_NULL_HANDLE && it->superseded) {
+      vkDestroyPipeline(this->Context.Device.logicalDevice, rebuilt, nullptr);  //? never bound
+    } else if (rebuilt != VK_NULL_HANDLE) {
+      VkPipeline old = VK_NULL_HANDLE;
+      auto &variant = this->pipelineVariants[it->target];
+      try {
+        old = variant.get();
+      } catch (const std::exception &) {
+        //? the variant never compiled, there is nothing to retire
+      }
+      variant = it->pipeline;
+      if (old != VK_NULL_HANDLE && old == this->graphicsPipeline)
+        this->graphicsPipeline = rebuilt;
+      this->swapPipeline(old, rebuilt);
+    }
+    it = this->pendingReloads.erase(it);
+  }
+
+  //# modules replaced by a reload go once no build can still be reading them
+  if (!this->pendingReloads.empty() || !this->shaderLibrary.hasRetired()) return;
+  for (const auto &variant : this->pipelineVariants)
+    if (variant.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+  this->shaderLibrary.releaseRetired();
+}
+
+void RenderV::swapPipeline(VkPipeline oldPipeline, VkPipeline newPipeline) {
+  if (oldPipeline == VK_NULL_HANDLE) return;
+  //* only the next recorded frame sees the new handle, frames in flight keep the old one
+  for (auto &set : this->instanceSets)
+    if (set.pipeline == oldPipeline) set.pipeline = newPipeline;
+  for (auto &draw : this->drawList)
+    if (draw.pipeline == oldPipeline) draw.pipeline = newPipeline;
+  const VkDevice device = this->Context.Device.logicalDevice;
+  this->deferDestroy([device, oldPipeline]() {
+    vkDestroyPipeline(device, oldPipeline, nullptr);
+  });
+}
+
+void RenderV::createOffscreenTargets() {
+  //* headless replacement for swapchain: one device-local color image per frame in flight
+  this->swapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+  this->swapChainExtent = this->config.headlessExtent;
+  for (uint32_t i = 0; i < this->config.framesInFlight; i++) {
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = this->swapChainImageFormat;
+    imageCreateInfo.extent = {this->swapChainExtent.width,
+                              this->swapChainExtent.height, 1};
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT;  //? transfer src for readback
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    //? sub-allocated from the device-local image pool
+    GpuImage offscreenImage = this->allocator.createImage(
+        imageCreateInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    SwapChainImage target = {};
+    target.image = offscreenImage.image;
+    target.imageView = this->createImageViews(
+        target.image, this->swapChainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT);
+    this->offscreenImages.push_back(offscreenImage);
+    this->swapChainImages.push_back(target);
+  }
+}
+
 VkImageView RenderV::createImageViews(VkImage img, VkFormat format,
                                       VkImageAspectFlags aspectFlags) {
   VkImageViewCreateInfo imageViewInfo = {};
@@ -314,12 +539,14 @@ VkPresentModeKHR RenderV::getBestPresentMode(
     const std::vector<VkPresentModeKHR> &presentationModes) {
   if (presentationModes.size() < 1)
     throw std::logic_error("Invalid Present Mode Error");
+  //? the pacing policy picks the mode, FIFO is the only one every surface has
   for (const auto &presentationMode : presentationModes) {
-    if (presentationMode == VK_PRESENT_MODE_MAILBOX_KHR) {
+    if (presentationMode == this->config.presentMode) {
       return presentationMode;
     }
   }
-  std::cerr << "FALL BACK PRESENT MODE VK_PRESENT_MODE_FIFO_KHR\n  ";
+  std::cerr << "PRESENT MODE " << this->config.presentMode
+            << " UNSUPPORTED, FALL BACK TO VK_PRESENT_MODE_FIFO_KHR\n  ";
   // vulkan guaranteed that `VK_PRESENT_MODE_FIFO_KHR` is present
   return VK_PRESENT_MODE_FIFO_KHR;
 }
@@ -354,53 +581,133 @@ VkExtent2D RenderV::chooseSwapExt(
 }
 
 void RenderV::createLogicalDevice() {
+  CPU_ZONE("createLogicalDevice");
   //? Get Queue Families From our chosen physical device
   const float HIGHEST_PRIORITY = 1.0;
   // physical device features for logical device to use
-  VkPhysicalDeviceFeatures deviceFeatures = {};
-  vkGetPhysicalDeviceFeatures(this->Context.Device.physicalDevice,
-                              &deviceFeatures);
+  VkPhysicalDeviceVulkan12Features supportedFeatures12 = {};
+  supportedFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  VkPhysicalDeviceFeatures2 deviceFeatures = {};
+  deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  deviceFeatures.pNext = &supportedFeatures12;
+  vkGetPhysicalDeviceFeatures2(this->Context.Device.physicalDevice,
+                               &deviceFeatures);
+  //? 1.2 features are opt-in, only enable the ones the renderer uses
+  this->enabledFeatures12 = {};
+  this->enabledFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  //* frame and upload synchronization is built on timeline semaphores
+  if (!supportedFeatures12.timelineSemaphore)
+    throw std::runtime_error("GPU does not support timeline semaphores");
+  this->enabledFeatures12.timelineSemaphore = VK_TRUE;
+  //? bindless heap: update-after-bind, partially bound runtime arrays
+  if (!supportedFeatures12.descriptorIndexing ||
+      !supportedFeatures12.runtimeDescriptorArray ||
+      !supportedFeatures12.descriptorBindingPartiallyBound ||
+      !supportedFeatures12.descriptorBindingSampledImageUpdateAfterBind ||
+      !supportedFeatures12.descriptorBindingStorageBufferUpdateAfterBind ||
+      !supportedFeatures12.descriptorBindingUpdateUnusedWhilePending)
+    throw std::runtime_error("Device doesn't support descriptor indexing");
+  this->enabledFeatures12.descriptorIndexing = VK_TRUE;
+  this->enabledFeatures12.runtimeDescriptorArray = VK_TRUE;
+  this->enabledFeatures12.descriptorBindingPartiallyBound = VK_TRUE;
+  this->enabledFeatures12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+  this->enabledFeatures12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+  this->enabledFeatures12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+  this->enabledFeatures12.shaderSampledImageArrayNonUniformIndexing =
+      supportedFeatures12.shaderSampledImageArrayNonUniformIndexing;
+  this->enabledFeatures12.shaderStorageBufferArrayNonUniformIndexing =
+      supportedFeatures12.shaderStorageBufferArrayNonUniformIndexing;
+  deviceFeatures.pNext = &this->enabledFeatures12;
+  this->enabledFeatures = deviceFeatures.features;
+
+  //* low latency pacing: present_id + present_wait when the device has them
+  std::vector<const char *> extensions = this->getDeviceExtensions();
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+  presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+  presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+  bool presentWait = false;
+  if (!this->config.headless && this->config.lowLatency &&
+      this->hasDeviceExtension(this->Context.Device.physicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+      this->hasDeviceExtension(this->Context.Device.physicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    VkPhysicalDeviceFeatures2 presentFeatures = {};
+    presentFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    presentFeatures.pNext = &presentIdFeatures;
+    vkGetPhysicalDeviceFeatures2(this->Context.Device.physicalDevice, &presentFeatures);
+    presentWait = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+  }
+  if (presentWait) {
+    extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    this->enabledFeatures12.pNext = &presentIdFeatures;  //? presentIdFeatures -> presentWaitFeatures
+  }
 
   QueueFamilyIndices indices =
       this->getQueueFamilies(this->Context.Device.physicalDevice);
   if (!indices.isValidGraphicsFamily())
     throw std::runtime_error("Device doesn't support Required Queue Family");
   // queues that logical device needs to create.queue create info
-  VkDeviceQueueCreateInfo queueCreateInfo = {};
-  queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-  queueCreateInfo.queueFamilyIndex =
-      indices.graphicsFamily;  //? index of graphics family to create queue from
-  queueCreateInfo.queueCount = 1;
-  queueCreateInfo.pQueuePriorities =
-      &HIGHEST_PRIORITY;  //! QUEUE priority must be between 0.0 and 1.0
+  std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+  const bool asyncCompute =
+      this->config.asyncCompute && indices.isValidAsyncComputeFamily();
+  std::vector<int> queueFamilies = {indices.graphicsFamily, indices.transferFamily};
+  if (asyncCompute) queueFamilies.push_back(indices.asyncComputeFamily);
+  for (const int family : queueFamilies) {
+    bool created = false;
+    for (const auto &info : queueCreateInfos)
+      created |= info.queueFamilyIndex == static_cast<uint32_t>(family);
+    if (created) continue;
+    VkDeviceQueueCreateInfo queueCreateInfo = {};
+    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueCreateInfo.queueFamilyIndex =
+        family;  //? index of queue family to create queue from
+    queueCreateInfo.queueCount = 1;
+    queueCreateInfo.pQueuePriorities =
+        &HIGHEST_PRIORITY;  //! QUEUE priority must be between 0.0 and 1.0
+    queueCreateInfos.push_back(queueCreateInfo);
+  }
 
   //?info to create logical device
   VkDeviceCreateInfo logicalDeviceCreateInfo = {};
   logicalDeviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-  logicalDeviceCreateInfo.queueCreateInfoCount =
-      1;  // number of queues to create
+  logicalDeviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(
+      queueCreateInfos.size());  // number of queues to create
   logicalDeviceCreateInfo.pQueueCreateInfos =
-      &queueCreateInfo;  // queue create infos for logical device to use queues
+      queueCreateInfos.data();  // queue create infos for logical device to use queues
   logicalDeviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(
-      this->deviceExtensions.size());  // we dont need it for device
+      extensions.size());  // we dont need it for device
   logicalDeviceCreateInfo.ppEnabledExtensionNames =
-      this->deviceExtensions
-          .data();  // we're not using any extensions for our logical device
-  logicalDeviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+      extensions.data();  // we're not using any extensions for our logical device
+  logicalDeviceCreateInfo.pNext = &deviceFeatures;  //? features2 chain replaces pEnabledFeatures
+  logicalDeviceCreateInfo.pEnabledFeatures = nullptr;
   // creating logical device
   if (vkCreateDevice(this->Context.Device.physicalDevice,
                      &logicalDeviceCreateInfo, nullptr,
                      &this->Context.Device.logicalDevice) != VK_SUCCESS) {
     throw std::runtime_error("failed to create logical device");
   }
+  this->enabledFeatures12.pNext = nullptr;  //? the chain above lived on this stack frame
+  if (presentWait) {
+    this->waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+        vkGetDeviceProcAddr(this->Context.Device.logicalDevice, "vkWaitForPresentKHR"));
+  }
   //? if we're here that's mean logical device creation successfully
   // ? now we can get the queue created by logical device
   vkGetDeviceQueue(this->Context.Device.logicalDevice, indices.graphicsFamily,
                    0, &this->graphicsQueue);
+  //? same family means the same queue, uploads then skip ownership transfers
+  vkGetDeviceQueue(this->Context.Device.logicalDevice, indices.transferFamily,
+                   0, &this->transferQueue);
+  this->computeQueue = this->graphicsQueue;
+  if (asyncCompute)
+    vkGetDeviceQueue(this->Context.Device.logicalDevice,
+                     indices.asyncComputeFamily, 0, &this->computeQueue);
   // ? setting up presentation family which will work as interface between
   // display and swapchain
-  vkGetDeviceQueue(this->Context.Device.logicalDevice, indices.presentFamily, 0,
-                   &this->presentationQueue);
+  if (indices.isValidPresentFamily())
+    vkGetDeviceQueue(this->Context.Device.logicalDevice, indices.presentFamily,
+                     0, &this->presentationQueue);
 }
 
 void RenderV::getPhysicalDevice() {
@@ -420,6 +727,8 @@ void RenderV::getPhysicalDevice() {
       break;
     }
   }
+  if (this->Context.Device.physicalDevice == VK_NULL_HANDLE)
+    throw std::runtime_error("Could not find a suitable physical device");
 }
 
 SwapChainInfo RenderV::getSwapChainInfo(VkPhysicalDevice device) const {
@@ -452,164 +761,256 @@ SwapChainInfo RenderV::getSwapChainInfo(VkPhysicalDevice device) const {
 }
 
 void RenderV::createGraphicsPipeline() {
-  //? Create Shader Module
-  const auto vertexShaderModule = this->createShaderModule("D:/Projects/Personal/CG/vkGuide/src/shader/vertex.spv");
-  const auto fragmentShaderModule = this->createShaderModule("D:/Projects/Personal/CG/vkGuide/src/shader/fragment.spv");
-
-  //# VERTEX SHADER STAGE CREATION INFO
-  VkPipelineShaderStageCreateInfo vertexShaderStageCreateInfo = {};
-  vertexShaderStageCreateInfo.sType =VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-  vertexShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-  vertexShaderStageCreateInfo.module = vertexShaderModule;
-  vertexShaderStageCreateInfo.pName ="main";  // target function from where to start
-
-  //# FRAGMENT SHADER STAGE CREATION INFO
-  VkPipelineShaderStageCreateInfo fragmentShaderStageCreateInfo = {};
-  fragmentShaderStageCreateInfo.sType =VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-  fragmentShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-  fragmentShaderStageCreateInfo.module = fragmentShaderModule;
-  fragmentShaderStageCreateInfo.pName ="main";  // target function from where to start
-
-  VkPipelineShaderStageCreateInfo shaderStages[] = {
-    vertexShaderStageCreateInfo,
-    fragmentShaderStageCreateInfo
-};
-  //# Create GRAPHICS PIPELINE
-
-
-
-  //# Vertex Input (put in vertex description)
-  VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo = {};
-  vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-  vertexInputCreateInfo.vertexBindingDescriptionCount = 0;
-  vertexInputCreateInfo.pVertexBindingDescriptions = nullptr; // * List of vertex Binding Description (data spacing and stride info)
-  vertexInputCreateInfo.vertexAttributeDescriptionCount = 0;
-  vertexInputCreateInfo.pVertexAttributeDescriptions = nullptr;  // * List of vertex Attribiute Description
-
-  //# INPUT ASSEMBLY
-  VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo = {};
-  inputAssemblyCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-  inputAssemblyCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST; // * how vertices or point will be assembled
-  inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE; //* we're telling vulkan that stop drawing current shape, just start a new one
-
-  //# VIEWPORT & SCISSOR
-  VkViewport viewport = {}; // ! require for VkPipelineViewportStateCreateInfo
-  viewport.x = 0.0f;
-  viewport.y = 0.0f;
-  viewport.width = static_cast<float>(this->swapChainExtent.width);
-  viewport.height = static_cast<float>(this->swapChainExtent.height);
-  viewport.minDepth = 0.0f; // * the closest point (min depth of frame buffer)
-  viewport.maxDepth = 1.0f;//* fartest point (max depth of frame buffer)
-
-  //* creating scissor info
-  VkRect2D scissor = {}; // ! require for VkPipelineViewportStateCreateInfo
-  scissor.offset = {0,0}; //? offset to use region form
-  scissor.extent = this->swapChainExtent;//? available region to use
-
-  VkPipelineViewportStateCreateInfo viewportStateCreateInfo = {};
-  viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-  viewportStateCreateInfo.viewportCount = 1;
-  viewportStateCreateInfo.pViewports = &viewport;
-  viewportStateCreateInfo.scissorCount = 1;
-  viewportStateCreateInfo.pScissors = &scissor;
-
-  //# RASTERIZER
-  VkPipelineRasterizationStateCreateInfo  rasterizerCreateInfo = {};
-  rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-  rasterizerCreateInfo.depthClampEnable = VK_FALSE; //* controls near and far planes of the viewport, know as depth clipping.
-  rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
-  rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL; //* how to paint the surface of the polygon. we can use VK_POLYGON_MODE_FILL for wireframe effect. But we need GPU feature
-  rasterizerCreateInfo.lineWidth = 1.0f; //* how thick the line should be.other than 1.0 we need GPU feature
-  rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT; //* which face to cull/skip
-  rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE; //* Winding to determine which side is front
-  rasterizerCreateInfo.depthBiasClamp = VK_FALSE; //* whether to add depth bias to fragment (require for shadow mapping)
-
-  //# MULTISAMPLING
-  VkPipelineMultisampleStateCreateInfo multisampleCreateInfo = {};
-  multisampleCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-  multisampleCreateInfo.sampleShadingEnable = VK_FALSE; //!Currently we're disabling multisampling
-  multisampleCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-  //# Blending (how to blend multiple color in fragment)
-
-  VkPipelineColorBlendAttachmentState colorBlendAttachmentState = {};
-  colorBlendAttachmentState.colorWriteMask =  VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |  VK_COLOR_COMPONENT_B_BIT |  VK_COLOR_COMPONENT_A_BIT;
-  colorBlendAttachmentState.blendEnable = VK_TRUE; // Enable Color Blending
-  //* Blend Equation: (VK_BLEND_FACTOR_SRC_ALPHA * newColor) + (VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA * oldColor)
-  colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-  colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-  colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
-  colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-  colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-  colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
-
-  VkPipelineColorBlendStateCreateInfo colorBlendCreateInfo = {};
-  colorBlendCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-  colorBlendCreateInfo.logicOpEnable = VK_FALSE; //? AAlternative to calculation is to use logic operation
-  colorBlendCreateInfo.attachmentCount = 1;
-  colorBlendCreateInfo.pAttachments = &colorBlendAttachmentState;
-
-  //* Pipeline Layout ( TODO: Apply Future Descriptor set layout)
+  CPU_ZONE("createGraphicsPipeline");
+  //* Pipeline Layout: set 0 is the bindless heap, set 1 the per-draw uniform ring,
+  //* small per-draw data is a push constant
+  const VkDescriptorSetLayout setLayouts[] = {this->bindless.getLayout(),
+                                              this->drawUniformLayout};
+  VkPushConstantRange drawConstantRange = {};
+  drawConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+  drawConstantRange.offset = 0;
+  drawConstantRange.size = sizeof(DrawConstants);
   VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
   pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  pipelineLayoutCreateInfo.setLayoutCount = 0;
-  pipelineLayoutCreateInfo.pSetLayouts = nullptr;
-  pipelineLayoutCreateInfo.pushConstantRangeCount=0;
-  pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+  pipelineLayoutCreateInfo.setLayoutCount = 2;
+  pipelineLayoutCreateInfo.pSetLayouts = setLayouts;
+  pipelineLayoutCreateInfo.pushConstantRangeCount=1;
+  pipelineLayoutCreateInfo.pPushConstantRanges = &drawConstantRange;
   if (vkCreatePipelineLayout(this->Context.Device.logicalDevice,&pipelineLayoutCreateInfo,nullptr,&this->pipelineLayout)!=VK_SUCCESS) {
     throw std::runtime_error("failed to create pipeline layout");
   }
 
-  //TODO: SETUP DEPTH & STENCIL TESTING
-  VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {};
-  graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-  graphicsPipelineCreateInfo.stageCount = 2; //? number of shader stages
-  graphicsPipelineCreateInfo.pStages = shaderStages; //? shaders
-  graphicsPipelineCreateInfo.pVertexInputState = &vertexInputCreateInfo;
-  graphicsPipelineCreateInfo.pInputAssemblyState = &inputAssemblyCreateInfo;
-  graphicsPipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-  graphicsPipelineCreateInfo.pDynamicState = nullptr;
-  graphicsPipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
-  graphicsPipelineCreateInfo.pMultisampleState = &multisampleCreateInfo;
-  graphicsPipelineCreateInfo.pColorBlendState = &colorBlendCreateInfo;
-  graphicsPipelineCreateInfo.pDepthStencilState = nullptr;
-  graphicsPipelineCreateInfo.layout = pipelineLayout; //?pipeline layout
-  graphicsPipelineCreateInfo.renderPass = renderPass; //?render pass description
-  graphicsPipelineCreateInfo.subpass = 0;
-  //* PIPELINE DERIVATIVES TO CREATE MULTIPLE PIPELINE THAT DERIVE FROM ONE ANOTHER FOR OPTIMIZATION
-  graphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-  graphicsPipelineCreateInfo.basePipelineIndex = -1;
+  //# Create GRAPHICS PIPELINE (compiled on the builder's worker pool)
+  //? the first frame needs this one, so wait for it right away
+  //? registered as the all-features variant, so reloads and getShaderVariant share it
+  this->graphicsPipeline = this->getShaderVariant(SHADER_FEATURES_ALL).get();
+}
+
+GraphicsPipelineDesc RenderV::getDefaultPipelineDesc() const {
+  GraphicsPipelineDesc desc = {};
+  desc.vertexShader = "vertex.spv";
+  desc.fragmentShader = "fragment.spv";
+  //* one interleaved quantized stream, descriptions generated at compile time
+  constexpr auto vertexAttributes = QuantizedVertexLayout::attributes(0);
+  desc.vertexBindings = {QuantizedVertexLayout::binding(0)};
+  desc.vertexAttributes.assign(vertexAttributes.begin(), vertexAttributes.end());
+  //* instance streams follow the per-vertex attributes (locations 4 and 5)
+  constexpr auto transformAttributes = InstanceTransformLayout::attributes(
+      INSTANCE_TRANSFORM_BINDING, QuantizedVertexLayout::attributeCount);
+  constexpr auto colorAttributes = InstanceColorLayout::attributes(
+      INSTANCE_COLOR_BINDING, QuantizedVertexLayout::attributeCount +
+                                  InstanceTransformLayout::attributeCount);
+  desc.vertexBindings.push_back(
+      InstanceTransformLayout::binding(INSTANCE_TRANSFORM_BINDING));
+  desc.vertexBindings.push_back(
+      InstanceColorLayout::binding(INSTANCE_COLOR_BINDING));
+  desc.vertexAttributes.insert(desc.vertexAttributes.end(),
+                               transformAttributes.begin(),
+                               transformAttributes.end());
+  desc.vertexAttributes.insert(desc.vertexAttributes.end(),
+                               colorAttributes.begin(), colorAttributes.end());
+  desc.layout = this->pipelineLayout; //?pipeline layout
+  desc.renderPass = this->renderPass; //?render pass description
+  return desc;
+}
 
-  if (vkCreateGraphicsPipelines(this->Context.Device.logicalDevice,VK_NULL_HANDLE,1,&graphicsPipelineCreateInfo,nullptr,&this->graphicsPipeline)!=VK_SUCCESS) {
-    throw std::runtime_error("failed to create graphics pipeline");
+void RenderV::updateMeshBuffer(VkBuffer buffer, VkDeviceSize offset,
+                               const void *data, VkDeviceSize size) {
+  this->uploader.uploadBuffer(
+      buffer, offset, data, size,
+      VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+      VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+}
+
+Mesh RenderV::uploadMesh(const std::vector<Vertex> &vertices,
+                         const std::vector<uint32_t> &indices) {
+  CPU_ZONE("uploadMesh");
+  Mesh mesh = {};
+  mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+  mesh.indexCount = static_cast<uint32_t>(indices.size());
+
+  //* quantize positions into the mesh bounds, the shader scales them back
+  float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+  float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+  for (size_t i = 0; i < vertices.size(); i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      const float value = vertices[i].position[axis];
+      boundsMin[axis] = i == 0 ? value : std::min(boundsMin[axis], value);
+      boundsMax[axis] = i == 0 ? value : std::max(boundsMax[axis], value);
+    }
+  }
+  for (int axis = 0; axis < 3; axis++) {
+    const float halfExtent = 0.5f * (boundsMax[axis] - boundsMin[axis]);
+    mesh.decode.positionScale[axis] = halfExtent > 0.0f ? halfExtent : 1.0f;
+    mesh.decode.positionOffset[axis] =
+        0.5f * (boundsMax[axis] + boundsMin[axis]);
+  }
+  std::vector<QuantizedVertex> quantized(vertices.size());
+  for (size_t i = 0; i < vertices.size(); i++) {
+    const Vertex &vertex = vertices[i];
+    QuantizedVertex &packed = quantized[i];
+    for (int axis = 0; axis < 3; axis++) {
+      packed.position[axis] = quantizeSnorm16(
+          (vertex.position[axis] - mesh.decode.positionOffset[axis]) /
+          mesh.decode.positionScale[axis]);
+      packed.color[axis] = quantizeUnorm8(vertex.color[axis]);
+    }
+    packed.position[3] = 0;
+    packed.color[3] = 255;
+    const auto normal =
+        octEncodeSnorm16(vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+    packed.normal[0] = normal[0];
+    packed.normal[1] = normal[1];
+    packed.uv[0] = static_cast<uint16_t>(
+        std::lround(std::clamp(vertex.uv[0], 0.0f, 1.0f) * 65535.0f));
+    packed.uv[1] = static_cast<uint16_t>(
+        std::lround(std::clamp(vertex.uv[1], 0.0f, 1.0f) * 65535.0f));
   }
 
+  const VkDeviceSize vertexSize = sizeof(QuantizedVertex) * quantized.size();
+  const VkDeviceSize indexSize = sizeof(uint32_t) * indices.size();
+  GpuBuffer vertexBuffer = this->allocator.createBuffer(
+      vertexSize,
+      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  this->ownedBuffers.push_back(vertexBuffer);
+  GpuBuffer indexBuffer = this->allocator.createBuffer(
+      indexSize,
+      VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  this->ownedBuffers.push_back(indexBuffer);
+  //? copies are queued on the transfer queue and flushed before the next frame
+  this->uploader.uploadBuffer(vertexBuffer.buffer, 0, quantized.data(),
+                              vertexSize, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+                              VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+  this->uploader.uploadBuffer(indexBuffer.buffer, 0, indices.data(), indexSize,
+                              VK_ACCESS_INDEX_READ_BIT,
+                              VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+  mesh.vertexBuffer = vertexBuffer.buffer;
+  mesh.indexBuffer = indexBuffer.buffer;
+  return mesh;
+}
 
+uint32_t RenderV::createTexture(uint32_t width, uint32_t height,
+                               const void *rgba8) {
+  VkImageCreateInfo imageCreateInfo = {};
+  imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+  imageCreateInfo.extent = {width, height, 1};
+  imageCreateInfo.mipLevels = 1;
+  imageCreateInfo.arrayLayers = 1;
+  imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  GpuImage image = this->allocator.createImage(imageCreateInfo,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  const VkImageView view = this->createImageViews(
+      image.image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
+  this->uploader.uploadImage(image.image, {width, height, 1}, rgba8,
+                             4ull * width * height,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_ACCESS_SHADER_READ_BIT,
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+  //? the slot is valid right away, draws only sample it after the upload's barrier
+  const uint32_t slot =
+      this->bindless.addImage(view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  this->textures[slot] = {image, view};
+  return slot;
+}
 
+uint32_t RenderV::createStorageBuffer(const void *data, VkDeviceSize size) {
+  GpuBuffer buffer = this->allocator.createBuffer(
+      size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  this->uploader.uploadBuffer(buffer.buffer, 0, data, size,
+                              VK_ACCESS_SHADER_READ_BIT,
+                              VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                  VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+  const uint32_t slot = this->bindless.addBuffer(buffer.buffer, 0, size);
+  this->storageBuffers[slot] = buffer;
+  return slot;
+}
 
-  //! DESTROY SHADER MODULE AFTER PIPELINE CREATION
-  vkDestroyShaderModule(this->Context.Device.logicalDevice,
-                        fragmentShaderModule, nullptr);
-  vkDestroyShaderModule(this->Context.Device.logicalDevice, vertexShaderModule,
-                        nullptr);
+void RenderV::deferDestroy(std::function<void()> destroy) {
+  //* keyed on the next frame submit, not the last one: uploads recorded but not
+  //* flushed yet go out before it and signal lower values on the same timeline
+  this->deletionQueue.push(std::move(destroy));
+}
 
+void RenderV::destroyMesh(const Mesh &mesh) {
+  for (const VkBuffer handle : {mesh.vertexBuffer, mesh.indexBuffer}) {
+    const auto found = std::find_if(
+        this->ownedBuffers.begin(), this->ownedBuffers.end(),
+        [handle](const GpuBuffer &buffer) { return buffer.buffer == handle; });
+    if (handle == VK_NULL_HANDLE || found == this->ownedBuffers.end()) continue;
+    GpuBuffer buffer = *found;
+    this->ownedBuffers.erase(found);
+    this->deferDestroy([this, buffer]() mutable { this->allocator.destroyBuffer(buffer); });
+  }
 }
 
-VkShaderModule RenderV::createShaderModule(std::string shaderPath) const {
-  const auto shader = RenderV::parseSpirV(shaderPath);
-  VkShaderModuleCreateInfo createInfo = {};
-  createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  createInfo.codeSize = shader.size();
-  createInfo.pCode = reinterpret_cast<const uint32_t *>(shader.data());
-  VkShaderModule shaderModule = VK_NULL_HANDLE;
-  if (vkCreateShaderModule(this->Context.Device.logicalDevice, &createInfo,
-                           nullptr, &shaderModule) != VK_SUCCESS) {
-    throw std::runtime_error("failed to create shader module");
+void RenderV::destroyTexture(uint32_t slot) {
+  const auto found = this->textures.find(slot);
+  if (found == this->textures.end()) return;
+  BindlessTexture texture = found->second;
+  this->textures.erase(found);
+  //? the slot is recycled with the image, not before: in-flight frames may still sample it
+  this->deferDestroy([this, slot, texture]() mutable {
+    this->bindless.releaseImage(slot);
+    vkDestroyImageView(this->Context.Device.logicalDevice, texture.view, nullptr);
+    this->allocator.destroyImage(texture.image);
+  });
+}
+
+void RenderV::destroyStorageBuffer(uint32_t slot) {
+  const auto found = this->storageBuffers.find(slot);
+  if (found == this->storageBuffers.end()) return;
+  GpuBuffer buffer = found->second;
+  this->storageBuffers.erase(found);
+  this->deferDestroy([this, slot, buffer]() mutable {
+    this->bindless.releaseBuffer(slot);
+    this->allocator.destroyBuffer(buffer);
+  });
+}
+
+std::vector<std::shared_future<VkPipeline>> RenderV::buildPipelines(
+    std::vector<GraphicsPipelineDesc> descs) {
+  for (auto &desc : descs) {
+    if (desc.layout == VK_NULL_HANDLE) desc.layout = this->pipelineLayout;
+    if (desc.renderPass == VK_NULL_HANDLE) desc.renderPass = this->renderPass;
   }
-  return shaderModule;
+  auto futures = this->pipelineBuilder.build(descs);
+  //? renderer owns the variants and destroys them at shutdown
+  this->pipelineVariants.insert(this->pipelineVariants.end(), futures.begin(),
+                                futures.end());
+  this->pipelineVariantDescs.insert(this->pipelineVariantDescs.end(),
+                                    descs.begin(), descs.end());
+  return futures;
+}
+
+std::shared_future<VkPipeline> RenderV::getShaderVariant(uint32_t features) {
+  features &= SHADER_FEATURES_ALL;
+  const auto found = this->shaderVariants.find(features);
+  if (found != this->shaderVariants.end()) return this->pipelineVariants[found->second];
+  //* same desc as the built-in pipeline, only the specialization differs
+  GraphicsPipelineDesc desc = this->getDefaultPipelineDesc();
+  //? all features are the shaders' defaults, the built-in pipeline stays unspecialized
+  if (features != SHADER_FEATURES_ALL)
+    desc.specialization = makeShaderSpecialization(features);
+  this->shaderVariants.emplace(features, this->pipelineVariants.size());
+  return this->buildPipelines({desc}).front();
+}
+
+VkShaderModule RenderV::createShaderModule(const std::string &shaderPath) {
+  //? mapped and created once, the library keeps the module until shutdown
+  return this->shaderLibrary.load(shaderPath);
 }
 
 void RenderV::createRenderPass() {
+  CPU_ZONE("createRenderPass");
   //*create color attachment of render pass
   VkAttachmentDescription colorAttachment = {};
   colorAttachment.format = this->swapChainImageFormat;  //?format to use in attachment
@@ -619,7 +1020,9 @@ void RenderV::createRenderPass() {
   colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; //? what to do with stencil before rendering
   colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;//? what to do with stencil after rendering
   colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; //? image data layout before render pass start
-  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;//? image data will change to it after render pass
+  colorAttachment.finalLayout = this->config.headless
+                                    ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL  //? headless targets are read back, not presented
+                                    : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;//? image data will change to it after render pass
 
   //* Attachment Reference uses an index that refers to index in attachment list passes into VkRenderPassCreateInfo
   VkAttachmentReference colorAttachmentReference = {};
@@ -698,34 +1101,103 @@ void RenderV::createCMDPool() {
   VkCommandPoolCreateInfo poolCreateInfo = {};
   poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
   poolCreateInfo.queueFamilyIndex =  queueFamilyIndicies.graphicsFamily;
-  //?Create Graphics Queue Family Command Pool
-  if (vkCreateCommandPool(this->Context.Device.logicalDevice,&poolCreateInfo,nullptr,&this->graphicsCMDPool)!=VK_SUCCESS) {
-    throw std::runtime_error("Failed to create graphics command pool");
+  poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; //? short lived buffers, reset wholesale every frame
+  //?Create one Graphics Queue Family Command Pool per frame in flight
+  this->frameCMDPools.resize(this->config.framesInFlight);
+  for (auto& pool : this->frameCMDPools) {
+    if (vkCreateCommandPool(this->Context.Device.logicalDevice,&poolCreateInfo,nullptr,&pool)!=VK_SUCCESS) {
+      throw std::runtime_error("Failed to create graphics command pool");
+    }
   }
 }
 
 void RenderV::createCommandBuffers() {
-  const auto size_of_frame_buffer = static_cast<uint32_t>(this->swapChainImages.size());
-  this->commandBuffers.resize(size_of_frame_buffer);
+  this->commandBuffers.resize(this->config.framesInFlight);
   VkCommandBufferAllocateInfo cmdAllocateInfo = {};
   cmdAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  cmdAllocateInfo.commandPool = this->graphicsCMDPool;
   cmdAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; //* Execution order:VK_COMMAND_BUFFER_LEVEL_PRIMARY  signature that it will be executed by queue not other command buffer
-  cmdAllocateInfo.commandBufferCount = size_of_frame_buffer;
+  cmdAllocateInfo.commandBufferCount = 1;
+
+  //? frame i records into a buffer from its own pool, so resetting the pool resets the buffer
+  for (uint32_t i = 0; i < this->config.framesInFlight; i++) {
+    cmdAllocateInfo.commandPool = this->frameCMDPools[i];
+    if (vkAllocateCommandBuffers(this->Context.Device.logicalDevice,&cmdAllocateInfo,&this->commandBuffers[i])!=VK_SUCCESS) {
+      throw std::runtime_error("Failed to allocate command buffers");
+    }
+  }
+}
 
-  if (vkAllocateCommandBuffers(this->Context.Device.logicalDevice,&cmdAllocateInfo,this->commandBuffers.data())!=VK_SUCCESS) {
-    throw std::runtime_error("Failed to allocate command buffers");
+void RenderV::createComputeCommandBuffers(uint32_t computeFamily) {
+  VkCommandPoolCreateInfo poolCreateInfo = {};
+  poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolCreateInfo.queueFamilyIndex = computeFamily;
+  poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+  VkCommandBufferAllocateInfo cmdAllocateInfo = {};
+  cmdAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  cmdAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  cmdAllocateInfo.commandBufferCount = 1;
+  //? same scheme as the graphics buffers: frame i owns pool i, reset wholesale
+  this->frameComputePools.resize(this->config.framesInFlight);
+  this->computeCommandBuffers.resize(this->config.framesInFlight);
+  for (uint32_t i = 0; i < this->config.framesInFlight; i++) {
+    if (vkCreateCommandPool(this->Context.Device.logicalDevice,&poolCreateInfo,nullptr,&this->frameComputePools[i])!=VK_SUCCESS)
+      throw std::runtime_error("Failed to create compute command pool");
+    cmdAllocateInfo.commandPool = this->frameComputePools[i];
+    if (vkAllocateCommandBuffers(this->Context.Device.logicalDevice,&cmdAllocateInfo,&this->computeCommandBuffers[i])!=VK_SUCCESS)
+      throw std::runtime_error("Failed to allocate compute command buffers");
   }
 }
 
-void RenderV::recordCommands() const {
+uint64_t RenderV::submitAsyncCompute() {
+  if (this->cullJobs.empty()) return 0;
+  CPU_ZONE("submitAsyncCompute");
+  const auto frame = static_cast<uint32_t>(this->currentFrame);
+  const VkCommandBuffer commandBuffer = this->computeCommandBuffers[frame];
+  //! the graphics submit that last waited on this slot's compute work has finished, the pool is idle
+  vkResetCommandPool(this->Context.Device.logicalDevice,this->frameComputePools[frame],0);
+  VkCommandBufferBeginInfo cmdBeginInfo = {};
+  cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (vkBeginCommandBuffer(commandBuffer,&cmdBeginInfo)!=VK_SUCCESS)
+    throw std::runtime_error("failed to begin recording compute command buffer");
+  //? own query pools, reset on this queue: the graphics frame has not begun yet
+  this->gpuProfiler.beginFrame(commandBuffer,frame,this->computeProfilerQueue);
+  const uint32_t cullScope = this->gpuProfiler.beginScope(commandBuffer,frame,"cull",this->computeProfilerQueue);
+  this->culler.record(commandBuffer,frame,this->frameDescriptors,this->cullJobOffset,
+                      static_cast<uint32_t>(this->cullJobs.size()),this->cullMaxObjects,this->frustumPlanes);
+  this->gpuProfiler.endScope(commandBuffer,frame,cullScope,this->computeProfilerQueue);
+  if (vkEndCommandBuffer(commandBuffer)!=VK_SUCCESS)
+    throw std::runtime_error("failed to stop recording compute command buffer");
+
+  //* nothing to wait on: inputs are host written, outputs per frame slot were
+  //* last read by a graphics submit the CPU has already waited for
+  const uint64_t computeValue = this->computeTimeline.next();
+  const VkSemaphore timeline = this->computeTimeline.get();
+  VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.signalSemaphoreValueCount = 1;
+  timelineInfo.pSignalSemaphoreValues = &computeValue;
+  VkSubmitInfo submitInfo = {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.pNext = &timelineInfo;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &commandBuffer;
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores = &timeline;
+  if (vkQueueSubmit(this->computeQueue,1,&submitInfo,VK_NULL_HANDLE)!=VK_SUCCESS)
+    throw std::runtime_error("failed to submit async compute");
+  return computeValue;
+}
+
+void RenderV::recordCommands(uint32_t imageIndex) {
+  CPU_ZONE("recordCommands");
   VkClearValue clearValue[]={
     {0.25,0.5,0.65,1.0}
   };
-  const auto cmdBufferSize = this->swapChainImages.size();
+  const auto commandBuffer = this->commandBuffers[this->currentFrame];
   VkCommandBufferBeginInfo cmdBeginInfo = {};
   cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
- // cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+  cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
   //* info about begin render pass
   VkRenderPassBeginInfo renderPassBeginInfo = {};
   renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -734,48 +1206,237 @@ void RenderV::recordCommands() const {
   renderPassBeginInfo.renderArea.extent = this->swapChainExtent;
   renderPassBeginInfo.clearValueCount = 1;
   renderPassBeginInfo.pClearValues = clearValue;
+  renderPassBeginInfo.framebuffer = this->swapChainFrameBuffers[imageIndex];
 
-  for (int i = 0; i < cmdBufferSize; i++) {
-    renderPassBeginInfo.framebuffer = this->swapChainFrameBuffers[i];
-    vkBeginCommandBuffer(this->commandBuffers[i],&cmdBeginInfo)!=VK_SUCCESS?
-    throw std::runtime_error("failed to begin recording command buffers"):0;
-    //*do tasks
-    //? init render pass
-    vkCmdBeginRenderPass(this->commandBuffers[i],&renderPassBeginInfo,VK_SUBPASS_CONTENTS_INLINE);
-      //* Bind pipeline with renderpass
-      vkCmdBindPipeline(this->commandBuffers[i],VK_PIPELINE_BIND_POINT_GRAPHICS,this->graphicsPipeline);
-      //?Execute Pipeline
-      vkCmdDraw(this->commandBuffers[i],3,1,0,0);
-    vkCmdEndRenderPass(this->commandBuffers[i]);
-    vkEndCommandBuffer(this->commandBuffers[i])!=VK_SUCCESS?
-    throw std::runtime_error("failed to stop recording command buffers"):0;
+  //* viewport & scissor are dynamic pipeline state
+  VkViewport viewport = {};
+  viewport.width = static_cast<float>(this->swapChainExtent.width);
+  viewport.height = static_cast<float>(this->swapChainExtent.height);
+  viewport.maxDepth = 1.0f;
+  VkRect2D scissor = {};
+  scissor.extent = this->swapChainExtent;
+
+  //* secondaries inherit the render pass state they will run in
+  VkCommandBufferInheritanceInfo inheritanceInfo = {};
+  inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+  inheritanceInfo.renderPass = this->renderPass;
+  inheritanceInfo.subpass = 0;
+  inheritanceInfo.framebuffer = renderPassBeginInfo.framebuffer;
+
+  //? draw work is split across the recorder's threads
+  this->buildFrameDrawList();
+  //* culling is kicked off before the draws are recorded, so it overlaps the
+  //* previous frame's graphics work on the GPU and this frame's recording on the CPU
+  this->frameComputeValue = this->asyncComputeActive ? this->submitAsyncCompute() : 0;
+  const auto secondaries = this->commandRecorder.record(
+      static_cast<uint32_t>(this->currentFrame), inheritanceInfo,
+      this->frameDrawList, viewport, scissor, this->frameUniformSet);
+
+  //! frame's timeline value has been waited on, everything allocated from its pool is free again
+  vkResetCommandPool(this->Context.Device.logicalDevice,this->frameCMDPools[this->currentFrame],0);
+  vkBeginCommandBuffer(commandBuffer,&cmdBeginInfo)!=VK_SUCCESS?
+  throw std::runtime_error("failed to begin recording command buffers"):0;
+  const auto frame = static_cast<uint32_t>(this->currentFrame);
+  //? reads the previous results of this frame's queries, then resets them
+  this->gpuProfiler.beginFrame(commandBuffer,frame);
+  const uint32_t frameScope = this->gpuProfiler.beginScope(commandBuffer,frame,"frame");
+  //? without an async queue, culling runs ahead of the render pass in the same submission
+  if (!this->cullJobs.empty() && !this->asyncComputeActive) {
+    const uint32_t cullScope = this->gpuProfiler.beginScope(commandBuffer,frame,"cull");
+    this->culler.record(commandBuffer,frame,this->frameDescriptors,this->cullJobOffset,
+                        static_cast<uint32_t>(this->cullJobs.size()),this->cullMaxObjects,this->frustumPlanes);
+    this->gpuProfiler.endScope(commandBuffer,frame,cullScope);
   }
+  //? init render pass, contents come from secondary command buffers
+  const uint32_t renderScope = this->gpuProfiler.beginScope(commandBuffer,frame,"render pass");
+  vkCmdBeginRenderPass(commandBuffer,&renderPassBeginInfo,VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    if (!secondaries.empty())
+      vkCmdExecuteCommands(commandBuffer,static_cast<uint32_t>(secondaries.size()),secondaries.data());
+  vkCmdEndRenderPass(commandBuffer);
+  this->gpuProfiler.endScope(commandBuffer,frame,renderScope);
+  this->gpuProfiler.endScope(commandBuffer,frame,frameScope);
+  vkEndCommandBuffer(commandBuffer)!=VK_SUCCESS?
+  throw std::runtime_error("failed to stop recording command buffers"):0;
 }
 
 
+void RenderV::buildFrameDrawList() {
+  CPU_ZONE("buildFrameDrawList");
+  this->frameDrawList.assign(this->drawList.begin(), this->drawList.end());
+  const uint32_t defaultUniforms = this->streamDrawUniforms();
+  this->cullJobs.clear();
+  this->cullMaxObjects = 0;
+  LinearArena &arena = this->frameArenas[this->currentFrame];
+  uint32_t visibleCount = 0;
+  for (const auto &set : this->instanceSets) {
+    if (set.size() == 0) continue;
+    //* stream the SoA arrays into this frame's mapped ring slot, one draw per set
+    const BufferSlice transforms = arena.allocate(
+        sizeof(InstanceTransform) * set.transforms.size(), 16);
+    std::memcpy(transforms.mapped, set.transforms.data(), transforms.size);
+    const BufferSlice colors =
+        arena.allocate(sizeof(uint32_t) * set.colors.size(), 16);
+    std::memcpy(colors.mapped, set.colors.data(), colors.size);
+
+    DrawItem draw = {};
+    draw.pipeline = set.pipeline != VK_NULL_HANDLE ? set.pipeline
+                                                    : this->graphicsPipeline;
+    draw.vertexBuffer = set.mesh.vertexBuffer;
+    draw.indexBuffer = set.mesh.indexBuffer;
+    draw.indexCount = set.mesh.indexCount;
+    draw.instanceCount = set.size();
+    draw.layout = this->pipelineLayout;
+    draw.decode = set.mesh.decode;
+    draw.textureIndex = set.textureIndex;
+    draw.materialIndex = set.materialIndex;
+    draw.uniformOffset = defaultUniforms;
+    draw.instanceBuffer = transforms.buffer;
+    draw.instanceTransformOffset = transforms.offset;
+    draw.instanceColorOffset = colors.offset;
+    if (this->gpuCullingActive) {
+      //? one instanced command per set, survivors are listed in the visible buffer
+      CullJob job = {};
+      const MeshDecode &decode = set.mesh.decode;
+      std::copy(decode.positionOffset, decode.positionOffset + 3,
+                job.boundingSphere);
+      //? the snorm cube [-1,1]^3 scaled per axis bounds every vertex
+      job.boundingSphere[3] = std::sqrt(
+          decode.positionScale[0] * decode.positionScale[0] +
+          decode.positionScale[1] * decode.positionScale[1] +
+          decode.positionScale[2] * decode.positionScale[2]);
+      job.objectCount = set.size();
+      job.visibleBase = visibleCount;
+      job.transformBase = static_cast<uint32_t>(transforms.offset / 16);
+      job.indexCount = set.mesh.indexCount;
+      draw.indirectOffset =
+          sizeof(VkDrawIndexedIndirectCommand) * this->cullJobs.size();
+      draw.maxDrawCount = 1;
+      draw.visibleBase = visibleCount;
+      visibleCount += set.size();
+      this->cullMaxObjects = std::max(this->cullMaxObjects, set.size());
+      this->cullJobs.push_back(job);
+    }
+    this->frameDrawList.push_back(draw);
+  }
+  //* set 1 bindings 1 and 2: the culled sets fetch instance data through these
+  VkDescriptorBufferInfo bufferInfos[2] = {};
+  bufferInfos[0].buffer = arena.getBuffer();  //? never read without culling, any buffer will do
+  bufferInfos[0].range = VK_WHOLE_SIZE;
+  bufferInfos[1].buffer = arena.getBuffer();
+  bufferInfos[1].range = VK_WHOLE_SIZE;
+  if (!this->cullJobs.empty()) {
+    const BufferSlice jobs =
+        arena.allocate(sizeof(CullJob) * this->cullJobs.size(), 16);
+    std::memcpy(jobs.mapped, this->cullJobs.data(), jobs.size);
+    this->cullJobOffset = jobs.offset;
+    const auto frame = static_cast<uint32_t>(this->currentFrame);
+    this->culler.reserve(frame, visibleCount,
+                         static_cast<uint32_t>(this->cullJobs.size()));
+    for (auto &draw : this->frameDrawList) {
+      if (draw.maxDrawCount == 0) continue;
+      draw.indirectBuffer = this->culler.getCommandBuffer(frame);
+    }
+    bufferInfos[0].buffer = this->culler.getVisibleBuffer(frame);
+  }
+  VkWriteDescriptorSet writes[2] = {};
+  for (uint32_t i = 0; i < 2; i++) {
+    writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[i].dstSet = this->frameUniformSet;
+    writes[i].dstBinding = i + 1;
+    writes[i].descriptorCount = 1;
+    writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writes[i].pBufferInfo = &bufferInfos[i];
+  }
+  vkUpdateDescriptorSets(this->Context.Device.logicalDevice, 2, writes, 0, nullptr);
+}
+
+uint32_t RenderV::streamDrawUniforms() {
+  LinearArena &arena = this->frameArenas[this->currentFrame];
+  const VkDeviceSize range = this->config.drawUniformRange;
+  const VkDeviceSize alignment = this->limits.minUniformBufferOffsetAlignment;
+  //* set 1 covers one range of the arena, draws only move the dynamic offset
+  this->frameUniformSet = this->frameDescriptors.allocate(
+      static_cast<uint32_t>(this->currentFrame), this->drawUniformLayout);
+  VkDescriptorBufferInfo bufferInfo = {};
+  bufferInfo.buffer = arena.getBuffer();
+  bufferInfo.offset = 0;
+  bufferInfo.range = range;
+  VkWriteDescriptorSet write = {};
+  write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  write.dstSet = this->frameUniformSet;
+  write.dstBinding = 0;
+  write.descriptorCount = 1;
+  write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  write.pBufferInfo = &bufferInfo;
+  vkUpdateDescriptorSets(this->Context.Device.logicalDevice, 1, &write, 0, nullptr);
+
+  //? shared by every draw without its own payload
+  const DrawUniforms defaults = {};
+  const BufferSlice defaultSlice = arena.allocate(range, alignment);
+  std::memcpy(defaultSlice.mapped, &defaults, sizeof(defaults));
+  const auto defaultOffset = static_cast<uint32_t>(defaultSlice.offset);
+  for (auto &draw : this->frameDrawList) {
+    if (draw.uniformData == nullptr) {
+      draw.uniformOffset = defaultOffset;
+      continue;
+    }
+    if (draw.uniformSize > range)
+      throw std::runtime_error("draw uniform payload exceeds drawUniformRange");
+    //! a full range per payload, the bound window must never run past the arena
+    const BufferSlice slice = arena.allocate(range, alignment);
+    std::memcpy(slice.mapped, draw.uniformData, draw.uniformSize);
+    draw.uniformOffset = static_cast<uint32_t>(slice.offset);
+  }
+  return defaultOffset;
+}
+
+uint32_t RenderV::createInstanceSet(const Mesh &mesh, VkPipeline pipeline) {
+  InstanceSet set = {};
+  set.mesh = mesh;
+  set.pipeline = pipeline;
+  this->instanceSets.push_back(std::move(set));
+  return static_cast<uint32_t>(this->instanceSets.size() - 1);
+}
+
 void RenderV::initSemaphores() {
-  this->imageAvailableSemaphore.resize(MAX_FRAMES_IN_FLIGHT);
-  this->renderFinishedSemaphore.resize(MAX_FRAMES_IN_FLIGHT);
-  this->drawFences.resize(MAX_FRAMES_IN_FLIGHT);
+  this->imageAvailableSemaphore.resize(this->config.framesInFlight);
+  this->renderFinishedSemaphore.resize(this->config.framesInFlight);
+  //? 0 = never submitted, waiting on it returns immediately
+  this->frameTimelineValues.assign(this->config.framesInFlight, 0);
   //semaphore creation info
   VkSemaphoreCreateInfo semaphoreCreateInfo = {};
   semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-  VkFenceCreateInfo fenceCreateInfo = {};
-  fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-  fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-  for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+  for (uint32_t i = 0; i < this->config.framesInFlight; i++) {
       if (vkCreateSemaphore(this->Context.Device.logicalDevice,&semaphoreCreateInfo,nullptr,&this->imageAvailableSemaphore[i])!=VK_SUCCESS ||
-          vkCreateSemaphore(this->Context.Device.logicalDevice,&semaphoreCreateInfo,nullptr,&this->renderFinishedSemaphore[i])!=VK_SUCCESS ||
-          vkCreateFence(this->Context.Device.logicalDevice,&fenceCreateInfo,nullptr,&this->drawFences[i])!=VK_SUCCESS
+          vkCreateSemaphore(this->Context.Device.logicalDevice,&semaphoreCreateInfo,nullptr,&this->renderFinishedSemaphore[i])!=VK_SUCCESS
           ){
-          throw std::runtime_error("Failed to create Semaphores or Fence");
+          throw std::runtime_error("Failed to create Semaphores");
         }
   }
 
 }
 
+void RenderV::paceFrame() {
+  if (!this->config.lowLatency || this->config.headless) return;
+  CPU_ZONE("paceFrame");
+  if (this->waitForPresent != nullptr) {
+    //* the previous frame is on screen before input is sampled for the next one
+    if (this->lastPresentId == 0 || this->lastPresentSwapChain != this->swapChain)
+      return;  //? ids restart meaning with every swapchain
+    const VkResult result = this->waitForPresent(
+        this->Context.Device.logicalDevice, this->swapChain, this->lastPresentId,
+        PRESENT_WAIT_TIMEOUT_NS);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) this->swapChainOutOfDate = true;
+    return;
+  }
+  //? no present_wait: at least keep the CPU from queueing frames ahead of the GPU
+  const uint32_t previous =
+      (static_cast<uint32_t>(this->currentFrame) + this->config.framesInFlight - 1) %
+      this->config.framesInFlight;
+  this->graphicsTimeline.wait(this->frameTimelineValues[previous]);
+}
+
 void RenderV::draw() {
   /*
     TODO:
@@ -785,30 +1446,126 @@ void RenderV::draw() {
     3. Present image to screen when it signals finished rendering
    */
   VkPipelineStageFlags stageFlags[] = {
-    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT //? async culling output: indirect commands + visible list
   };
 
-  vkWaitForFences(this->Context.Device.logicalDevice,1,&this->drawFences[this->currentFrame],VK_TRUE,std::numeric_limits<uint64_t>::max());
-  vkResetFences(this->Context.Device.logicalDevice,1,&this->drawFences[this->currentFrame]);
+  CPU_ZONE("draw");
+  {
+    CPU_ZONE("vkWaitSemaphores");
+    this->graphicsTimeline.wait(this->frameTimelineValues[this->currentFrame]);
+  }
+  {
+    CPU_ZONE("deletionQueue");
+    this->deletionQueue.flush(this->graphicsTimeline.getCompleted());
+  }
+  this->frameArenas[this->currentFrame].reset(); //? GPU is done reading this frame's scratch data
+  this->frameDescriptors.reset(static_cast<uint32_t>(this->currentFrame));
+  //? pending uploads are submitted ahead of the frame, the graphics queue only waits on their semaphore
+  {
+    CPU_ZONE("uploads");
+    this->uploader.collect();
+    this->uploader.flush();
+  }
+  //? between frames: swap in recompiled pipelines, the old ones go to the deletion queue
+  this->applyShaderReloads();
+
+  if (this->config.headless) {
+    this->destroyRetiredSwapChains(false);
+    if (this->swapChainOutOfDate) this->recreateSwapChain();
+    this->recordCommands(static_cast<uint32_t>(this->currentFrame));
+    //? offscreen target i belongs to frame i, so the wait above already guards it
+    const uint64_t frameValue = this->graphicsTimeline.next();
+    const VkSemaphore timeline = this->graphicsTimeline.get();
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &frameValue;
+    const VkSemaphore computeSemaphore = this->computeTimeline.get();
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    if (this->frameComputeValue != 0) {
+      timelineInfo.waitSemaphoreValueCount = 1;
+      timelineInfo.pWaitSemaphoreValues = &this->frameComputeValue;
+      submitInfo.waitSemaphoreCount = 1;
+      submitInfo.pWaitSemaphores = &computeSemaphore;
+      submitInfo.pWaitDstStageMask = &stageFlags[1];
+    }
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &this->commandBuffers[this->currentFrame];
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline;
+    CPU_ZONE("vkQueueSubmit");
+    if (vkQueueSubmit(this->graphicsQueue,1,&submitInfo,VK_NULL_HANDLE)!=VK_SUCCESS) {
+      throw std::runtime_error("failed to submit command buffer submission");
+    }
+    this->frameTimelineValues[this->currentFrame] = frameValue;
+    this->deletionQueue.stamp(frameValue);
+    if (this->frameCounter == 0) this->reportFirstFrame();
+    this->frameCounter++;
+    currentFrame++;
+    if (currentFrame>=static_cast<int>(this->config.framesInFlight))currentFrame=0;
+    return;
+  }
+
+  this->destroyRetiredSwapChains(false);
+  if (this->swapChainOutOfDate && !this->recreateSwapChain()) return; //? minimized, skip frame
 
   //#1: GEt Next Image to be drawn and get signal semaphore when ready to be drawn
   uint32_t imageIndex;
-  vkAcquireNextImageKHR(this->Context.Device.logicalDevice,this->swapChain,std::numeric_limits<uint64_t>::max(),this->imageAvailableSemaphore[this->currentFrame],VK_NULL_HANDLE,&imageIndex);
+  VkResult acquireResult;
+  {
+    CPU_ZONE("vkAcquireNextImageKHR");
+    acquireResult = vkAcquireNextImageKHR(this->Context.Device.logicalDevice,this->swapChain,std::numeric_limits<uint64_t>::max(),this->imageAvailableSemaphore[this->currentFrame],VK_NULL_HANDLE,&imageIndex);
+  }
+  if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+    //? semaphore was not signalled and nothing was submitted, rebuild and retry next frame
+    this->swapChainOutOfDate = true;
+    return;
+  }
+  if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) {
+    throw std::runtime_error("failed to acquire swapchain image");
+  }
+  this->recordCommands(imageIndex);
 
   //#2: Submit Command buffer to queue
+  //? binary semaphores ignore their value slot, only the timeline one is read
+  const uint64_t frameValue = this->graphicsTimeline.next();
+  const uint64_t waitValues[] = {0, this->frameComputeValue};
+  const VkSemaphore waitSemaphores[] = {
+    this->imageAvailableSemaphore[this->currentFrame], this->computeTimeline.get()
+  };
+  const uint32_t waitCount = this->frameComputeValue != 0 ? 2 : 1;
+  const uint64_t signalValues[] = {0, frameValue};
+  const VkSemaphore signalSemaphores[] = {
+    this->renderFinishedSemaphore[this->currentFrame], this->graphicsTimeline.get()
+  };
+  VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.waitSemaphoreValueCount = waitCount;
+  timelineInfo.pWaitSemaphoreValues = waitValues;
+  timelineInfo.signalSemaphoreValueCount = 2;
+  timelineInfo.pSignalSemaphoreValues = signalValues;
   VkSubmitInfo submitInfo = {};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.waitSemaphoreCount = 1;
-  submitInfo.pWaitSemaphores = &this->imageAvailableSemaphore[this->currentFrame]; //? wait until imageAvailableSemaphore is set to true
+  submitInfo.pNext = &timelineInfo;
+  submitInfo.waitSemaphoreCount = waitCount;
+  submitInfo.pWaitSemaphores = waitSemaphores; //? wait until imageAvailableSemaphore is set to true (and culling finished)
   submitInfo.pWaitDstStageMask = stageFlags; // ? stage list when semaphores will be checked
   submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &this->commandBuffers[imageIndex];
-  submitInfo.signalSemaphoreCount = 1; // ? Number of semaphores to be signales
-  submitInfo.pSignalSemaphores = &this->renderFinishedSemaphore[this->currentFrame];
+  submitInfo.pCommandBuffers = &this->commandBuffers[this->currentFrame];
+  submitInfo.signalSemaphoreCount = 2; // ? Number of semaphores to be signales
+  submitInfo.pSignalSemaphores = signalSemaphores; //? present waits on the first, the CPU on the second
   //?submit command buffer to queue
-  if (vkQueueSubmit(this->graphicsQueue,1,&submitInfo,this->drawFences[this->currentFrame])!=VK_SUCCESS) { // ? when drawing will complete then signal the fence
-    throw std::runtime_error("failed to submit command buffer submission");
+  {
+    CPU_ZONE("vkQueueSubmit");
+    if (vkQueueSubmit(this->graphicsQueue,1,&submitInfo,VK_NULL_HANDLE)!=VK_SUCCESS) {
+      throw std::runtime_error("failed to submit command buffer submission");
+    }
   }
+  this->frameTimelineValues[this->currentFrame] = frameValue;
+  this->deletionQueue.stamp(frameValue);
 
   //#3 Render Image to scene
   VkPresentInfoKHR presentInfo = {};
@@ -818,98 +1575,349 @@ void RenderV::draw() {
   presentInfo.swapchainCount = 1; //* Number of swapchain to present to
   presentInfo.pSwapchains = &this->swapChain; // * swap chain where image will be presented
   presentInfo.pImageIndices = &imageIndex; //* index of image that to be drawn
-  if (vkQueuePresentKHR(this->presentationQueue,&presentInfo)!=VK_SUCCESS) {
+  //? tag the present so paceFrame() can wait for it to reach the screen
+  VkPresentIdKHR presentIdInfo = {};
+  const uint64_t presentId = this->lastPresentId + 1;
+  if (this->waitForPresent != nullptr) {
+    presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds = &presentId;
+    presentInfo.pNext = &presentIdInfo;
+  }
+  VkResult presentResult;
+  {
+    CPU_ZONE("vkQueuePresentKHR");
+    presentResult = vkQueuePresentKHR(this->presentationQueue,&presentInfo);
+  }
+  if (this->waitForPresent != nullptr) {
+    this->lastPresentId = presentId;
+    this->lastPresentSwapChain = this->swapChain;
+  }
+  if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+    this->swapChainOutOfDate = true; //? rebuilt at the start of the next frame
+  } else if (presentResult != VK_SUCCESS) {
     throw std::runtime_error("failed to present");
   }
 
   //* Get Next Frame
+  if (this->frameCounter == 0) this->reportFirstFrame();
+  this->frameCounter++;
   currentFrame++;
-  if (currentFrame>=MAX_FRAMES_IN_FLIGHT)currentFrame=0;
+  if (currentFrame>=static_cast<int>(this->config.framesInFlight))currentFrame=0;
 }
 
 
-int RenderV::init(GLFWwindow *window) {
+int RenderV::init(GLFWwindow *window, const RenderVConfig &renderConfig) {
+  this->initStart = std::chrono::steady_clock::now();
+  CPU_ZONE("init");
   try {
     this->Window = window;
+    this->config = renderConfig;
+    this->config.framesInFlight = std::clamp(this->config.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT_LIMIT);
+    if (!this->config.headless && this->Window == nullptr)
+      throw std::runtime_error("window is required unless running headless");
     this->createVulkanInstance();
-    this->createSurface();
+    if (!this->config.headless) this->createSurface();
     this->getPhysicalDevice();
     this->createLogicalDevice();
-    this->createSwapChain();
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(this->Context.Device.physicalDevice, &properties);
+    this->limits = properties.limits;
+    this->allocator.init(this->Context.Device.physicalDevice,
+                         this->Context.Device.logicalDevice);
+    this->layoutCache.init(this->Context.Device.logicalDevice);
+    this->frameDescriptors.init(this->Context.Device.logicalDevice,
+                                this->config.framesInFlight, &this->layoutCache);
+    const QueueFamilyIndices queueFamilies =
+        this->getQueueFamilies(this->Context.Device.physicalDevice);
+    //? buffers touched by both the graphics and the async compute queue
+    std::vector<uint32_t> computeSharedFamilies;
+    if (this->computeQueue != this->graphicsQueue)
+      computeSharedFamilies = {static_cast<uint32_t>(queueFamilies.graphicsFamily),
+                               static_cast<uint32_t>(queueFamilies.asyncComputeFamily)};
+    //? per-frame scratch memory, reset once the frame's timeline value has been reached
+    this->frameArenas.resize(this->config.framesInFlight);
+    for (auto &arena : this->frameArenas) {
+      arena.init(this->allocator, this->config.frameArenaSize,
+                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 computeSharedFamilies);
+    }
+    this->graphicsTimeline.init(this->Context.Device.logicalDevice);
+    const bool sharedTransfer = this->transferQueue == this->graphicsQueue;
+    if (!sharedTransfer)
+      this->transferTimeline.init(this->Context.Device.logicalDevice);
+    this->uploader.init(this->Context.Device.logicalDevice, this->allocator,
+                        static_cast<uint32_t>(queueFamilies.transferFamily),
+                        this->transferQueue,
+                        sharedTransfer ? this->graphicsTimeline : this->transferTimeline,
+                        static_cast<uint32_t>(queueFamilies.graphicsFamily),
+                        this->graphicsQueue, this->graphicsTimeline,
+                        this->config.stagingRingSize,
+                        properties.limits.optimalBufferCopyOffsetAlignment);
+    this->pipelineCache.init(this->Context.Device.logicalDevice, properties,
+                             this->config.pipelineCachePath);
+    const std::string assetRoot = this->config.assetRoot.empty()
+                                      ? std::string(VKGUIDE_SHADER_DIR)
+                                      : this->config.assetRoot;
+    this->shaderLibrary.init(this->Context.Device.logicalDevice, assetRoot);
+    if (this->config.useAssetArchive) {
+      //* one mapping for every shader instead of an open() per file
+      const bool explicitArchive = !this->config.assetArchive.empty();
+      const std::string archivePath =
+          explicitArchive ? this->config.assetArchive : VKGUIDE_ASSET_ARCHIVE;
+      if (explicitArchive || std::ifstream(archivePath).good()) {
+        this->assetArchive.open(archivePath);  //? a broken archive is an error, not a silent fallback
+        this->shaderLibrary.setArchive(&this->assetArchive);
+      }
+    }
+    //? recompiled .spv land in the asset root, reloaded paths bypass the archive
+    if (this->config.shaderHotReload &&
+        !this->shaderWatcher.start(VKGUIDE_SHADER_SOURCE_DIR, assetRoot, VKGUIDE_GLSLC))
+      std::cerr << "shader hot reload disabled" << std::endl;
+    this->pipelineBuilder.init(
+        this->Context.Device.logicalDevice, this->pipelineCache.get(),
+        [this](const std::string &path) {
+          return this->createShaderModule(path);
+        },
+        this->config.pipelineThreads);
+    if (this->config.headless)
+      this->createOffscreenTargets();
+    else
+      this->createSwapChain();
     this->createRenderPass();
+    //* bindless heap, sized to what the device allows after bind
+    VkPhysicalDeviceVulkan12Properties properties12 = {};
+    properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2 = {};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &properties12;
+    vkGetPhysicalDeviceProperties2(this->Context.Device.physicalDevice, &properties2);
+    this->bindless.init(
+        this->Context.Device.logicalDevice, this->layoutCache,
+        std::min({this->config.bindlessImages,
+                  properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                  properties12.maxDescriptorSetUpdateAfterBindSampledImages}),
+        std::min({this->config.bindlessBuffers,
+                  properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                  properties12.maxDescriptorSetUpdateAfterBindStorageBuffers}));
+    //* per-draw uniform ring: one dynamic uniform buffer over the frame arena
+    this->config.drawUniformRange =
+        std::min(this->config.drawUniformRange, this->limits.maxUniformBufferRange);
+    if (this->config.drawUniformRange < sizeof(DrawUniforms))
+      throw std::runtime_error("drawUniformRange is smaller than DrawUniforms");
+    VkDescriptorSetLayoutBinding drawUniformBinding = {};
+    drawUniformBinding.binding = 0;
+    drawUniformBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    drawUniformBinding.descriptorCount = 1;
+    drawUniformBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    //? 1: visible object indices from the cull pass, 2: the frame arena holding the instance data
+    VkDescriptorSetLayoutBinding visibleBinding = {};
+    visibleBinding.binding = 1;
+    visibleBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    visibleBinding.descriptorCount = 1;
+    visibleBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    VkDescriptorSetLayoutBinding instanceDataBinding = visibleBinding;
+    instanceDataBinding.binding = 2;
+    this->drawUniformLayout = this->layoutCache.get(
+        {drawUniformBinding, visibleBinding, instanceDataBinding});
     this->createGraphicsPipeline();
     this->createFrameBuffers();
     this->createCMDPool();
     this->createCommandBuffers();
-    this->recordCommands();
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(this->Context.Device.physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(this->Context.Device.physicalDevice, &familyCount, families.data());
+    if (this->config.gpuProfiling) {
+      //? timestamps are written on the graphics queue, its valid bits decide if they work at all
+      this->gpuProfiler.init(
+          this->Context.Device.logicalDevice, this->config.framesInFlight,
+          this->limits.timestampPeriod,
+          families[static_cast<uint32_t>(queueFamilies.graphicsFamily)].timestampValidBits);
+    }
+    this->commandRecorder.init(
+        this->Context.Device.logicalDevice,
+        static_cast<uint32_t>(queueFamilies.graphicsFamily),
+        this->config.framesInFlight, this->config.recordThreads);
+    this->commandRecorder.setGlobalDescriptorSet(this->pipelineLayout,
+                                                 this->bindless.getSet());
+    //? slot 0 defaults: a white texel and a white tint material
+    const uint32_t whiteTexel = 0xffffffffu;
+    this->createTexture(1, 1, &whiteTexel);
+    const float defaultTint[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    this->createStorageBuffer(defaultTint, sizeof(defaultTint));
+    //* GPU culling runs on the async compute queue when there is one,
+    //* otherwise it is recorded into the graphics command buffer
+    this->gpuCullingActive =
+        this->config.gpuCulling &&
+        (queueFamilies.computeFamily == queueFamilies.graphicsFamily ||
+         this->computeQueue != this->graphicsQueue);
+    if (this->gpuCullingActive) {
+      std::vector<VkBuffer> cullInputs;
+      for (const auto &arena : this->frameArenas)
+        cullInputs.push_back(arena.getBuffer());
+      this->culler.init(
+          this->Context.Device.logicalDevice, this->allocator,
+          this->layoutCache, this->pipelineCache.get(),
+          this->createShaderModule("cull.spv"),
+          cullInputs, computeSharedFamilies);
+      this->asyncComputeActive = this->computeQueue != this->graphicsQueue;
+      if (this->asyncComputeActive) {
+        this->computeTimeline.init(this->Context.Device.logicalDevice);
+        this->createComputeCommandBuffers(
+            static_cast<uint32_t>(queueFamilies.asyncComputeFamily));
+        //? the cull pass leaves the graphics command buffer, time it on its own queue
+        if (this->config.gpuProfiling)
+          this->computeProfilerQueue = this->gpuProfiler.addQueue(
+              "async compute",
+              families[static_cast<uint32_t>(queueFamilies.asyncComputeFamily)].timestampValidBits);
+      }
+    }
+    //? default scene: one triangle, uploaded like any other mesh
+    const Mesh triangle = this->uploadMesh(
+        {{{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.15f, 1.0f}, {0.0f, 1.0f}},
+         {{0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.1f, 0.85f, 0.25f}, {1.0f, 1.0f}},
+         {{0.0f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.5f, 0.0f}, {0.5f, 0.0f}}},
+        {0, 1, 2});
+    //? drawn through the instancing path, callers add more instances to set 0
+    const uint32_t triangleSet = this->createInstanceSet(triangle);
+    this->instanceSets[triangleSet].add(0.0f, 0.0f, 0.0f, 1.0f,
+                                        packColorUnorm8(1.0f, 1.0f, 1.0f));
     this->initSemaphores();
+    if (!this->config.headless) {
+      //? resize events only mark the swapchain stale, draw() rebuilds it
+      glfwSetWindowUserPointer(this->Window, this);
+      glfwSetFramebufferSizeCallback(
+          this->Window, [](GLFWwindow *resizedWindow, int, int) {
+            static_cast<RenderV *>(glfwGetWindowUserPointer(resizedWindow))
+                ->notifyFramebufferResized();
+          });
+    }
   } catch (const std::runtime_error &e) {
     const auto errorMessage = e.what();
     std::cerr << "Runtime Error: " << errorMessage << std::endl;
     return EXIT_FAILURE;
   }
 
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - this->initStart;
+  this->initMs = elapsed.count();
   return EXIT_SUCCESS;
 }
 
+void RenderV::reportFirstFrame() {
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - this->initStart;
+  this->timeToFirstFrameMs = elapsed.count();
+  std::cout << "Startup: init " << this->initMs << " ms, first frame "
+            << this->timeToFirstFrameMs << " ms ("
+            << (this->pipelineCache.isWarm() ? "warm" : "cold")
+            << " pipeline cache)" << std::endl;
+}
+
+void RenderV::waitIdle() const {
+  if (this->Context.Device.logicalDevice != VK_NULL_HANDLE)
+    vkDeviceWaitIdle(this->Context.Device.logicalDevice);
+}
+
 
 
 
 
 RenderV::~RenderV() {
+  if (this->Context.Device.logicalDevice == VK_NULL_HANDLE) {
+    //? init never got as far as a device (or was never called)
+    if (this->Context.Instance != VK_NULL_HANDLE)
+      vkDestroyInstance(this->Context.Instance, nullptr);
+    return;
+  }
   vkDeviceWaitIdle(this->Context.Device.logicalDevice); //! wait until everything is free.
-  for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+  this->deletionQueue.flushAll();  //? device is idle, every parked destroy is safe now
+  this->destroyRetiredSwapChains(true);
+  for (size_t i = 0; i < this->imageAvailableSemaphore.size(); i++) { //? may be empty if init failed early
     vkDestroySemaphore(this->Context.Device.logicalDevice,this->renderFinishedSemaphore[i],nullptr);
     vkDestroySemaphore(this->Context.Device.logicalDevice,this->imageAvailableSemaphore[i],nullptr);
-    vkDestroyFence(this->Context.Device.logicalDevice,this->drawFences[i],nullptr);
   }
-  vkDestroyCommandPool(this->Context.Device.logicalDevice,this->graphicsCMDPool,nullptr);
+  this->commandRecorder.destroy();
+  for (auto pool : this->frameCMDPools) {
+    vkDestroyCommandPool(this->Context.Device.logicalDevice,pool,nullptr);
+  }
+  for (auto pool : this->frameComputePools) {
+    vkDestroyCommandPool(this->Context.Device.logicalDevice,pool,nullptr);
+  }
   for (auto framebuffer : this->swapChainFrameBuffers) {
     vkDestroyFramebuffer(this->Context.Device.logicalDevice,framebuffer,nullptr);
 
   }
-  vkDestroyPipeline(this->Context.Device.logicalDevice,this->graphicsPipeline,nullptr);
+  this->shaderWatcher.stop();
+  //? wait for in-flight variants and fold the worker caches into the main one
+  this->pipelineBuilder.finish();
+  for (const auto &pending : this->pendingReloads) {
+    try {
+      vkDestroyPipeline(this->Context.Device.logicalDevice, pending.pipeline.get(), nullptr);
+    } catch (const std::exception &) {
+      //? failed reloads have nothing to destroy
+    }
+  }
+  for (const auto &variant : this->pipelineVariants) {
+    try {
+      vkDestroyPipeline(this->Context.Device.logicalDevice, variant.get(), nullptr);
+    } catch (const std::exception &) {
+      //? failed variants have nothing to destroy
+    }
+  }
+  this->pipelineBuilder.destroy();
+  this->shaderLibrary.destroy();  //? after the builder, its workers load modules
+  //? graphicsPipeline is one of pipelineVariants, destroyed with them
+  //? persist everything the driver compiled this run for the next startup
+  this->pipelineCache.save();
+  this->pipelineCache.destroy();
   vkDestroyRenderPass(this->Context.Device.logicalDevice,this->renderPass,nullptr);
   vkDestroyPipelineLayout(this->Context.Device.logicalDevice,this->pipelineLayout,nullptr);
   for (const auto &img : this->swapChainImages) {
     vkDestroyImageView(this->Context.Device.logicalDevice, img.imageView,
                        nullptr);
   }
-  vkDestroySwapchainKHR(this->Context.Device.logicalDevice, this->swapChain,
-                        nullptr);
-  vkDestroySurfaceKHR(this->Context.Instance, this->surface, nullptr);
-  if (this->Context.Device.logicalDevice != VK_NULL_HANDLE)
-    vkDestroyDevice(this->Context.Device.logicalDevice, nullptr);
-  if (this->Context.Instance != VK_NULL_HANDLE)
-    vkDestroyInstance(this->Context.Instance, nullptr);
-}
-
-std::vector<char> RenderV::parseSpirV(const std::string &file_path) {
-  FILE *file = fopen(file_path.c_str(), "rb");
-  if (!file) {
-    throw std::runtime_error("Failed to open file");
+  if (this->config.headless) {
+    for (auto &image : this->offscreenImages) {
+      this->allocator.destroyImage(image);
+    }
+  } else {
+    vkDestroySwapchainKHR(this->Context.Device.logicalDevice, this->swapChain,
+                          nullptr);
+    vkDestroySurfaceKHR(this->Context.Instance, this->surface, nullptr);
   }
-  if (fseek(file, 0, SEEK_END) != 0) {
-    fclose(file);
-    throw std::runtime_error("Failed to seek to end of file");
+  for (auto &arena : this->frameArenas) {
+    arena.destroy();
   }
-  long size = ftell(file);
-  if (size == -1) {
-    fclose(file);
-    throw std::runtime_error("Failed to get file size");
+  this->gpuProfiler.destroy();
+  this->culler.destroy();
+  this->uploader.destroy();
+  this->transferTimeline.destroy();
+  this->computeTimeline.destroy();
+  this->graphicsTimeline.destroy();
+  for (auto &buffer : this->ownedBuffers) {
+    this->allocator.destroyBuffer(buffer);
   }
-  if (fseek(file, 0, SEEK_SET) != 0) {
-    fclose(file);
-    throw std::runtime_error("Failed to seek to beginning of file");
+  for (auto &buffer : this->storageBuffers) {
+    this->allocator.destroyBuffer(buffer.second);
   }
-  std::vector<char> buffer(size);
-  size_t readSize = fread(buffer.data(), 1, size, file);
-  fclose(file);
-
-  if (readSize != static_cast<size_t>(size)) {
-    throw std::runtime_error("Failed to read complete file");
+  for (auto &texture : this->textures) {
+    vkDestroyImageView(this->Context.Device.logicalDevice, texture.second.view, nullptr);
+    this->allocator.destroyImage(texture.second.image);
   }
-  return buffer;
+  this->bindless.destroy();
+  this->frameDescriptors.destroy();
+  this->layoutCache.destroy();
+  this->allocator.destroy();
+  if (this->Context.Device.logicalDevice != VK_NULL_HANDLE)
+    vkDestroyDevice(this->Context.Device.logicalDevice, nullptr);
+  if (this->Context.Instance != VK_NULL_HANDLE)
+    vkDestroyInstance(this->Context.Instance, nullptr);
 }
-
-
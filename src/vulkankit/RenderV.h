@@ -5,62 +5,157 @@
 #ifndef RENDERV_H
 #define RENDERV_H
 #define GLFW_INCLUDE_VULKAN
-#define MAX_FRAMES_IN_FLIGHT 2
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
+#include "AssetArchive.h"
+#include "BindlessHeap.h"
+#include "CommandRecorder.h"
+#include "CpuProfiler.h"
+#include "DeletionQueue.h"
+#include "DescriptorAllocator.h"
+#include "GpuAllocator.h"
+#include "GpuCuller.h"
+#include "GpuProfiler.h"
 #include "Helper.h"
+#include "InstanceSet.h"
+#include "PipelineBuilder.h"
+#include "PipelineCache.h"
 #include "RenderVUtil.h"
+#include "ShaderLibrary.h"
+#include "ShaderWatcher.h"
+#include "StagingUploader.h"
+#include "TimelineSemaphore.h"
 
 const bool enable_validation_layers = true;
 
 class RenderV {
  private:
+  static constexpr uint32_t MAX_FRAMES_IN_FLIGHT_LIMIT = 8;  //? upper clamp of RenderVConfig::framesInFlight
+  static constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100'000'000;  //? never stall pacing for long
   int currentFrame = 0;
-  GLFWwindow* Window;
+  uint64_t frameCounter = 0;  //? total frames submitted, used to age retired resources
+  GLFWwindow* Window = nullptr;
+  RenderVConfig config;
   //* vulkan Components
-  VkContext Context;
-  VkQueue graphicsQueue;  //? To store graphics queue created by logical device
-  VkQueue presentationQueue;
-  VkSurfaceKHR surface;
-  VkSwapchainKHR swapChain;
+  VkContext Context = {};
+  VkQueue graphicsQueue = VK_NULL_HANDLE;  //? To store graphics queue created by logical device
+  VkQueue presentationQueue = VK_NULL_HANDLE;
+  VkQueue transferQueue = VK_NULL_HANDLE;  //? equals graphicsQueue without a transfer-only family
+  VkQueue computeQueue = VK_NULL_HANDLE;  //? equals graphicsQueue without an async compute family
+  VkSurfaceKHR surface = VK_NULL_HANDLE;
+  VkSwapchainKHR swapChain = VK_NULL_HANDLE;
   VkPipeline graphicsPipeline;
   VkPipelineLayout pipelineLayout;
   VkRenderPass renderPass;
   std::vector<SwapChainImage> swapChainImages;
   std::vector<VkFramebuffer> swapChainFrameBuffers;
-  std::vector<VkCommandBuffer> commandBuffers;
+  std::vector<VkCommandBuffer> commandBuffers;  //? primary buffers, one per frame in flight
+  std::vector<DrawItem> drawList;  //? caller supplied draws, recorded before the instance sets
+  std::vector<DrawItem> frameDrawList;  //? drawList + one draw per instance set, rebuilt every frame
+  std::vector<InstanceSet> instanceSets;
+  GpuCuller culler;
+  bool gpuCullingActive = false;  //? config asked for it and the device can do it
+  bool asyncComputeActive = false;  //? culling is submitted to computeQueue instead of the graphics buffer
+  std::vector<CullJob> cullJobs;  //? this frame's jobs, staged in the frame arena
+  VkDeviceSize cullJobOffset = 0;
+  uint32_t cullMaxObjects = 0;
+  float frustumPlanes[6][4] = {{1, 0, 0, 1},  {-1, 0, 0, 1}, {0, 1, 0, 1},
+                               {0, -1, 0, 1}, {0, 0, 1, 0},  {0, 0, -1, 1}};  //? clip space box
+  std::vector<RetiredSwapChain> retiredSwapChains;
+  bool swapChainOutOfDate = false;  //? set on resize / suboptimal / out of date presents
+  double lastSwapChainRecreateMs = 0.0;
+  std::vector<GpuImage> offscreenImages;  //? headless render targets
    const std::vector<const char*> validation_layers = {
       "VK_LAYER_KHRONOS_validation"};
 
   //* Pools
-  VkCommandPool graphicsCMDPool;
+  std::vector<VkCommandPool> frameCMDPools;  //? transient graphics pools, one per frame in flight
+  std::vector<VkCommandPool> frameComputePools;  //? transient async compute pools, one per frame in flight
+  std::vector<VkCommandBuffer> computeCommandBuffers;
+  PipelineCache pipelineCache;
+  AssetArchive assetArchive;  //? mapped for the renderer's lifetime, shader blobs point into it
+  ShaderLibrary shaderLibrary;
+  PipelineBuilder pipelineBuilder;
+  CommandRecorder commandRecorder;
+
+  //* Memory
+  GpuAllocator allocator;
+  std::vector<LinearArena> frameArenas;  //? per-frame linear scratch, one per frame in flight
+  StagingUploader uploader;
+  std::vector<GpuBuffer> ownedBuffers;  //? device local buffers of meshes
+  std::unordered_map<uint32_t, GpuBuffer> storageBuffers;  //? by bindless buffer slot
+  DescriptorLayoutCache layoutCache;
+  DescriptorAllocator frameDescriptors;  //? transient sets, pools reset per frame in flight
+  BindlessHeap bindless;
+  VkDescriptorSetLayout drawUniformLayout = VK_NULL_HANDLE;  //? set 1, dynamic uniform buffer + culled instance lookups, owned by layoutCache
+  VkDescriptorSet frameUniformSet = VK_NULL_HANDLE;  //? this frame's arena as set 1, from frameDescriptors
+  std::unordered_map<uint32_t, BindlessTexture> textures;  //? by bindless image slot
+  DeletionQueue deletionQueue;  //? keyed on graphics timeline values, flushed each frame
+  std::vector<std::shared_future<VkPipeline>> pipelineVariants;
+  std::vector<GraphicsPipelineDesc> pipelineVariantDescs;  //? parallel to pipelineVariants, rebuilt on shader reload
+  std::unordered_map<uint32_t, size_t> shaderVariants;  //? feature bitmask -> index into pipelineVariants
+
+  //* Shader hot reload
+  struct PendingReload {
+    size_t target = 0;  //? index into pipelineVariants, the built-in pipeline included
+    std::shared_future<VkPipeline> pipeline;
+    bool superseded = false;  //? a newer edit of the same pipeline is compiling, discard this one
+  };
+  ShaderWatcher shaderWatcher;
+  std::vector<PendingReload> pendingReloads;
   // * DEVICE EXTENSIONS
   const std::vector<const char*> deviceExtensions = {
       VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
   //* Vk Utility
+  VkPhysicalDeviceFeatures enabledFeatures = {};
+  VkPhysicalDeviceVulkan12Features enabledFeatures12 = {};
+  VkPhysicalDeviceLimits limits = {};
   VkFormat swapChainImageFormat;
   VkExtent2D swapChainExtent;
 
   //* Synchronization
+  PFN_vkWaitForPresentKHR waitForPresent = nullptr;  //? set when present_id + present_wait are enabled
+  uint64_t lastPresentId = 0;
+  VkSwapchainKHR lastPresentSwapChain = VK_NULL_HANDLE;  //? swapchain lastPresentId was queued on
   std::vector<VkSemaphore> imageAvailableSemaphore;
   std::vector<VkSemaphore> renderFinishedSemaphore;
-  std::vector<VkFence> drawFences;
+  //? binary semaphores only remain at the swapchain boundary, everything else is a timeline value
+  TimelineSemaphore graphicsTimeline;
+  TimelineSemaphore transferTimeline;  //? only created when transfers have their own queue
+  TimelineSemaphore computeTimeline;  //? only created when async compute is active
+  uint64_t frameComputeValue = 0;  //? compute value the current frame's graphics submit waits on, 0 = none
+  std::vector<uint64_t> frameTimelineValues;  //? graphics value signalled by each frame slot's last submit
+
+  //* Profiling
+  GpuProfiler gpuProfiler;
+  uint32_t computeProfilerQueue = UINT32_MAX;  //? gpuProfiler queue of the async compute submits
 
-  //? other utility
-  static std::vector<char> parseSpirV(const std::string& file_path);
+  //* Startup metrics
+  std::chrono::steady_clock::time_point initStart;
+  double initMs = 0.0;
+  double timeToFirstFrameMs = 0.0;
 
   //! vulkan functions
   // ? Create Functions
   void createVulkanInstance();
   void createLogicalDevice();
   void createSurface();
-  void createSwapChain();
-  VkShaderModule createShaderModule(std::string shaderPath) const;
+  void createSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
+  bool recreateSwapChain();
+  void destroyRetiredSwapChains(bool force);
+  void applyShaderReloads();
+  void swapPipeline(VkPipeline oldPipeline, VkPipeline newPipeline);
+  void createOffscreenTargets();
+  VkShaderModule createShaderModule(const std::string& shaderPath);
   void createGraphicsPipeline();
   void createRenderPass();
   VkImageView createImageViews(VkImage img, VkFormat format,
@@ -68,12 +163,18 @@ class RenderV {
   void createFrameBuffers();
   void createCMDPool();
   void createCommandBuffers();
+  void createComputeCommandBuffers(uint32_t computeFamily);
   void initSemaphores();
 
-  void recordCommands() const;
+  void reportFirstFrame();
+  void recordCommands(uint32_t imageIndex);
+  uint64_t submitAsyncCompute();  //? returns the compute timeline value to wait on, 0 when nothing was submitted
+  void buildFrameDrawList();
+  uint32_t streamDrawUniforms();  //? returns the offset of the default DrawUniforms
   // ? Getters
   VkApplicationInfo getAppInfo(std::string appName, std::string engineName);
   void getPhysicalDevice();
+  std::vector<const char*> getDeviceExtensions() const;
   QueueFamilyIndices getQueueFamilies(
       VkPhysicalDevice&
           device);  // ? for parsing queue families from any physical device
@@ -89,14 +190,72 @@ class RenderV {
   bool checkInstanceExtensionSupport(
       const std::vector<const char*>* inputExtensionList);
   bool checkDeviceExtensionSupport(VkPhysicalDevice& device);
+  static bool hasDeviceExtension(VkPhysicalDevice device, const char* name);
   bool checkDeviceSuitability(VkPhysicalDevice physicalDevice);
   void checkPhysicalDeviceInfo(VkPhysicalDevice& device);
 
  public:
   RenderV() = default;
   ~RenderV();
-  int init(GLFWwindow* window);
+  int init(GLFWwindow* window, const RenderVConfig& renderConfig = {});
+  //? low latency mode: blocks until the last present is on screen, call before sampling input
+  void paceFrame();
   void draw();
+  Mesh uploadMesh(const std::vector<Vertex>& vertices,
+                  const std::vector<uint32_t>& indices);
+  //? rewrites part of a mesh's vertex/index buffer through the staging ring,
+  //! no frame in flight may still read that range
+  void updateMeshBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data,
+                        VkDeviceSize size);
+  //? both return the bindless slot, reference it through InstanceSet/DrawItem indices
+  uint32_t createTexture(uint32_t width, uint32_t height, const void* rgba8);
+  uint32_t createStorageBuffer(const void* data, VkDeviceSize size);
+  uint32_t createInstanceSet(const Mesh& mesh,
+                             VkPipeline pipeline = VK_NULL_HANDLE);
+  //? runs once the next frame submit has completed, and with it every upload flushed before it
+  //! stop referencing the resource first (instance sets, draw list, pipelines)
+  void deferDestroy(std::function<void()> destroy);
+  //? the handles/slots are invalid right away, the GPU objects go through deferDestroy
+  void destroyMesh(const Mesh& mesh);
+  void destroyTexture(uint32_t slot);
+  void destroyStorageBuffer(uint32_t slot);
+  //? edit freely between frames, the streams are copied when the frame is recorded
+  InstanceSet& getInstanceSet(uint32_t id) { return this->instanceSets.at(id); }
+  //? planes are xyz normal pointing inwards + w distance, in instance space
+  void setFrustumPlanes(const float planes[6][4]) {
+    std::copy(&planes[0][0], &planes[0][0] + 24, &this->frustumPlanes[0][0]);
+  }
+  bool isGpuCullingActive() const { return this->gpuCullingActive; }
+  bool isAsyncComputeActive() const { return this->asyncComputeActive; }
+  void setDrawList(std::vector<DrawItem> draws) {
+    this->drawList = std::move(draws);
+  }
+  //? the built-in pipeline's description, a starting point for variants
+  GraphicsPipelineDesc getDefaultPipelineDesc() const;
+  //? with shader hot reload the renderer swaps the handles it holds (instance sets,
+  //? draw list), handles kept elsewhere go stale once a reload retires them
+  std::vector<std::shared_future<VkPipeline>> buildPipelines(
+      std::vector<GraphicsPipelineDesc> descs);
+  //? the built-in shaders specialized to a ShaderFeature mask, compiled on first
+  //? request and cached. SHADER_FEATURES_ALL is the built-in pipeline itself.
+  //! a shader reload replaces the cached future, call again instead of keeping one
+  std::shared_future<VkPipeline> getShaderVariant(uint32_t features);
+  void waitIdle() const;
+  void notifyFramebufferResized() { this->swapChainOutOfDate = true; }
+  //? headless only: offscreen targets are recreated at the start of the next frame
+  void setHeadlessExtent(VkExtent2D extent) {
+    this->config.headlessExtent = extent;
+    this->swapChainOutOfDate = true;
+  }
+  double getLastSwapChainRecreateMs() const {
+    return this->lastSwapChainRecreateMs;
+  }
+  double getTimeToFirstFrameMs() const { return this->timeToFirstFrameMs; }
+  const GpuProfiler& getGpuProfiler() const { return this->gpuProfiler; }
+  const ShaderLibrary& getShaderLibrary() const { return this->shaderLibrary; }
+  GpuAllocatorStats getMemoryStats() const { return this->allocator.getStats(); }
+  bool isHeadless() const { return this->config.headless; }
+  uint32_t getFramesInFlight() const { return this->config.framesInFlight; }
 };
 
 #endif  // RENDERV_H
@@ -6,6 +6,14 @@
 #define RENDERVUTIL_H
 #include <vulkan/vulkan.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GpuAllocator.h"
+#include "VertexLayout.h"
+
 
 typedef  struct {
     VkPhysicalDevice physicalDevice;
@@ -21,10 +29,25 @@ typedef struct {
 struct QueueFamilyIndices {
     int graphicsFamily = -1;
     int presentFamily = -1;
+    int transferFamily = -1; //? transfer-only family if present, otherwise graphics
+    int computeFamily = -1; //? graphics family when it can dispatch, so culling shares its command buffer
+    int asyncComputeFamily = -1; //? compute family without graphics, its queue runs alongside the graphics one
     bool isValidGraphicsFamily() {
         return graphicsFamily >=0;
     }
 
+    bool isValidTransferFamily() {
+        return transferFamily >=0;
+    }
+
+    bool isValidComputeFamily() {
+        return computeFamily >=0;
+    }
+
+    bool isValidAsyncComputeFamily() {
+        return asyncComputeFamily >=0;
+    }
+
     bool isValidPresentFamily() {
         return presentFamily >=0;
     }
@@ -41,6 +64,133 @@ struct SwapChainImage {
   VkImageView imageView;
 };
 
+//* full precision source vertex, quantized on upload
+struct Vertex {
+  float position[3];
+  float normal[3];
+  float color[3];
+  float uv[2];
+};
+
+//* what the GPU reads: 20 bytes instead of 44
+struct QuantizedVertex {
+  int16_t position[4];  //? snorm16 in the mesh bounds, w is padding
+  int16_t normal[2];    //? octahedral snorm16
+  uint8_t color[4];     //? unorm8 rgba
+  uint16_t uv[2];       //? unorm16, [0,1]
+};
+using QuantizedVertexLayout =
+    VertexLayout<VK_VERTEX_INPUT_RATE_VERTEX, AttributeSnorm16x4,
+                 AttributeSnorm16x2, AttributeUnorm8x4, AttributeUnorm16x2>;
+static_assert(sizeof(QuantizedVertex) == QuantizedVertexLayout::stride);
+static_assert(offsetof(QuantizedVertex, normal) == QuantizedVertexLayout::offsetOf(1));
+static_assert(offsetof(QuantizedVertex, color) == QuantizedVertexLayout::offsetOf(2));
+static_assert(offsetof(QuantizedVertex, uv) == QuantizedVertexLayout::offsetOf(3));
+
+//* per-mesh dequantization, pushed as vertex shader push constants
+//? position = snorm * positionScale + positionOffset
+struct MeshDecode {
+  float positionScale[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+  float positionOffset[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+//* per-draw push constants (vertex + fragment), mirrored in the shaders
+struct DrawConstants {
+  MeshDecode decode;
+  uint32_t textureIndex = 0;   //? bindless sampled image slot
+  uint32_t materialIndex = 0;  //? bindless storage buffer slot
+  uint32_t userData[2] = {0, 0};  //? small per-draw payload, free for custom shaders
+  uint32_t visibleBase = UINT32_MAX;  //? culled set: first slot in the visible list, else instance streams
+  uint32_t transformBase = 0;  //? culled set: instance transforms in the frame arena, vec4 units
+  uint32_t colorBase = 0;  //? culled set: instance colors in the frame arena, uint units
+  uint32_t reserved = 0;
+};
+
+//* default per-draw uniform block (set 1, binding 0), mirrored in the shaders.
+//* draws may stream any payload up to RenderVConfig::drawUniformRange bytes
+struct DrawUniforms {
+  float transform[16] = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+                         0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};  //? column major, applied last
+  float tint[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+//* DEVICE_LOCAL geometry, uploaded through the staging ring
+struct Mesh {
+  VkBuffer vertexBuffer = VK_NULL_HANDLE;
+  VkBuffer indexBuffer = VK_NULL_HANDLE;
+  uint32_t vertexCount = 0;
+  uint32_t indexCount = 0;
+  MeshDecode decode;
+};
+
+//* one draw of the frame's draw list, indexed when indexBuffer is set
+struct DrawItem {
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  uint32_t vertexCount = 0;
+  uint32_t instanceCount = 1;
+  uint32_t firstVertex = 0;
+  uint32_t firstInstance = 0;
+  VkBuffer vertexBuffer = VK_NULL_HANDLE;
+  VkBuffer indexBuffer = VK_NULL_HANDLE;  //? uint32 indices
+  uint32_t indexCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+  VkPipelineLayout layout = VK_NULL_HANDLE;  //? set to push the draw constants
+  MeshDecode decode;
+  uint32_t textureIndex = 0;
+  uint32_t materialIndex = 0;
+  uint32_t userData[2] = {0, 0};  //? pushed with the draw constants
+  const void* uniformData = nullptr;  //? larger payload, copied into the frame's uniform ring when recorded
+  uint32_t uniformSize = 0;
+  uint32_t uniformOffset = 0;  //? dynamic offset of set 1, filled in when the frame is built
+  VkBuffer instanceBuffer = VK_NULL_HANDLE;  //? SoA instance streams, bindings 1 and 2
+  VkDeviceSize instanceTransformOffset = 0;
+  VkDeviceSize instanceColorOffset = 0;
+  VkBuffer indirectBuffer = VK_NULL_HANDLE;  //? set: vkCmdDrawIndexedIndirect, written by GPU culling
+  VkDeviceSize indirectOffset = 0;
+  uint32_t maxDrawCount = 0;  //? commands read from indirectBuffer, more than 1 needs multiDrawIndirect
+  uint32_t visibleBase = UINT32_MAX;  //? culled set: instances are looked up through the visible list
+};
+
+//* swapchain generation waiting for in-flight frames before it can be destroyed
+struct RetiredSwapChain {
+  VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+  std::vector<SwapChainImage> images;  //? only image views are owned, images belong to swapChain
+  std::vector<VkFramebuffer> frameBuffers;
+  std::vector<GpuImage> offscreenImages;  //? headless targets, swapChain is null then
+  uint64_t retiredAtFrame = 0;  //? frame counter value when it was replaced
+};
+
+//* sampled image behind a bindless image slot
+struct BindlessTexture {
+  GpuImage image;
+  VkImageView view = VK_NULL_HANDLE;
+};
+
+//* renderer startup options
+struct RenderVConfig {
+  bool headless = false;  //? render into offscreen images, no window/surface/swapchain
+  VkExtent2D headlessExtent = {1320, 768};  //? size of offscreen images in headless mode
+  uint32_t framesInFlight = 2;  //? frames the CPU may queue ahead of the GPU, more = throughput, fewer = latency
+  VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;  //? FIFO when the surface lacks it
+  bool lowLatency = false;  //? paceFrame() waits for the last present (present_wait) or the last frame's timeline value
+  std::string assetRoot;  //? relative shader paths resolve against it, empty = the build's shader directory
+  bool useAssetArchive = true;  //? look assets up in a packed archive before the loose files
+  std::string assetArchive;  //? empty = the build's shaders.vkpa, skipped when it does not exist
+  std::string pipelineCachePath = "pipeline_cache.bin";  //? empty disables the on-disk cache
+  uint32_t pipelineThreads = 0;  //? pipeline compile workers, 0 = one per core
+  uint32_t recordThreads = 0;  //? command recording threads, 0 = one per core
+  VkDeviceSize frameArenaSize = 16ull << 20;  //? per-frame linear scratch memory, holds the instance streams
+  VkDeviceSize stagingRingSize = 16ull << 20;  //? host visible upload ring
+  uint32_t bindlessImages = 4096;  //? sampled image slots, clamped to device limits
+  uint32_t bindlessBuffers = 4096;  //? storage buffer slots, clamped to device limits
+  uint32_t drawUniformRange = 256;  //? bytes of per-draw uniform data each draw can see
+  bool gpuCulling = true;  //? cull instance sets in a compute pass, drawn with one indirect draw each
+  bool asyncCompute = true;  //? run culling on a dedicated compute queue when the device has one
+  bool shaderHotReload = false;  //? watch the GLSL sources, recompile and swap pipelines while running (Linux)
+  bool gpuProfiling = true;  //? timestamp queries around each pass, off when the queue has no timestamps
+};
+
 
 
 #endif //RENDERVUTIL_H
@@ -0,0 +1,153 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "ShaderLibrary.h"
+
+#include <stdexcept>
+
+#include "CpuProfiler.h"
+#include "MappedFile.h"
+
+void ShaderLibrary::init(VkDevice logicalDevice, const std::string &assetRoot) {
+  this->device = logicalDevice;
+  this->root = assetRoot;
+  if (!this->root.empty() && this->root.back() != '/' && this->root.back() != '\\')
+    this->root += '/';
+}
+
+namespace {
+bool isAbsolute(const std::string &path) {
+  return !path.empty() && (path[0] == '/' || path[0] == '\\' ||
+                           (path.size() > 1 && path[1] == ':'));  //? drive letter
+}
+}  // namespace
+
+std::string ShaderLibrary::resolve(const std::string &path) const {
+  return isAbsolute(path) ? path : this->root + path;
+}
+
+ShaderLibrary::ContentHash ShaderLibrary::hashCode(const uint32_t *words,
+                                                   size_t wordCount) {
+  //* FNV-1a and a multiply-xorshift mix over whole words, SPIR-V is a word stream anyway
+  ContentHash hash = {14695981039346656037ull, 0x9e3779b97f4a7c15ull};
+  for (size_t i = 0; i < wordCount; i++) {
+    hash.low ^= words[i];
+    hash.low *= 1099511628211ull;
+    hash.high = (hash.high ^ words[i]) * 0xff51afd7ed558ccdull;
+    hash.high ^= hash.high >> 29;
+  }
+  hash.low ^= wordCount;
+  hash.high ^= wordCount;
+  return hash;
+}
+
+VkShaderModule ShaderLibrary::create(const void *code, size_t size,
+                                     const std::string &name) {
+  //! vkCreateShaderModule reads pCode as uint32_t, anything else is invalid usage
+  if (size == 0 || size % 4 != 0)
+    throw std::runtime_error("SPIR-V size is not a multiple of 4: " + name);
+  if (reinterpret_cast<uintptr_t>(code) % 4 != 0)
+    throw std::runtime_error("SPIR-V is not 4-byte aligned: " + name);
+  const auto *words = static_cast<const uint32_t *>(code);
+  if (words[0] != SPIRV_MAGIC)
+    throw std::runtime_error("not a SPIR-V module: " + name);
+
+  const ContentHash hash = hashCode(words, size / 4);
+  const auto found = this->byContent.find(hash);
+  if (found != this->byContent.end()) {
+    this->stats.contentHits++;
+    return found->second;
+  }
+  VkShaderModuleCreateInfo createInfo = {};
+  createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  createInfo.codeSize = size;
+  createInfo.pCode = words;  //? straight from the mapping, the driver makes its own copy
+  VkShaderModule shaderModule = VK_NULL_HANDLE;
+  if (vkCreateShaderModule(this->device, &createInfo, nullptr, &shaderModule) !=
+      VK_SUCCESS)
+    throw std::runtime_error("failed to create shader module: " + name);
+  this->byContent.emplace(hash, shaderModule);
+  this->refs.emplace(shaderModule, ModuleRefs{hash});
+  this->stats.modules++;
+  return shaderModule;
+}
+
+VkShaderModule ShaderLibrary::load(const std::string &path) {
+  CPU_ZONE("loadShader");
+  const std::string resolved = this->resolve(path);
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const auto found = this->byPath.find(resolved);
+  if (found != this->byPath.end()) {
+    this->stats.pathHits++;
+    return found->second;
+  }
+  //* archived assets are named relative to the root, like the paths asking for them
+  if (this->archive != nullptr && !isAbsolute(path) &&
+      this->reloaded.count(resolved) == 0 && this->archive->find(path)) {
+    const AssetBlob blob = this->archive->read(path);
+    const VkShaderModule shaderModule = this->create(blob.data(), blob.size(), path);
+    this->byPath.emplace(resolved, shaderModule);
+    this->refs[shaderModule].paths++;
+    return shaderModule;
+  }
+  //? the mapping only has to live until the module is created
+  const MappedFile file(resolved);
+  const VkShaderModule shaderModule = this->create(file.data(), file.size(), resolved);
+  this->byPath.emplace(resolved, shaderModule);
+  this->refs[shaderModule].paths++;
+  return shaderModule;
+}
+
+VkShaderModule ShaderLibrary::load(const void *code, size_t size) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const VkShaderModule shaderModule = this->create(code, size, "<memory>");
+  this->refs[shaderModule].pinned = true;  //? the caller's use is not tracked
+  return shaderModule;
+}
+
+void ShaderLibrary::reload(const std::string &path) {
+  const std::string resolved = this->resolve(path);
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->reloaded.insert(resolved);
+  const auto found = this->byPath.find(resolved);
+  if (found == this->byPath.end()) return;
+  const VkShaderModule old = found->second;
+  this->byPath.erase(found);
+  //* out of the content map right away, identical code loads into a fresh module
+  ModuleRefs &moduleRefs = this->refs[old];
+  if (--moduleRefs.paths > 0 || moduleRefs.pinned) return;
+  this->byContent.erase(moduleRefs.hash);
+  this->refs.erase(old);
+  this->retired.push_back(old);
+}
+
+bool ShaderLibrary::hasRetired() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return !this->retired.empty();
+}
+
+void ShaderLibrary::releaseRetired() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (const VkShaderModule shaderModule : this->retired)
+    vkDestroyShaderModule(this->device, shaderModule, nullptr);
+  this->retired.clear();
+}
+
+ShaderLibrary::Stats ShaderLibrary::getStats() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->stats;
+}
+
+void ShaderLibrary::destroy() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (const auto &entry : this->byContent)
+    vkDestroyShaderModule(this->device, entry.second, nullptr);
+  for (const VkShaderModule shaderModule : this->retired)
+    vkDestroyShaderModule(this->device, shaderModule, nullptr);
+  this->byContent.clear();
+  this->byPath.clear();
+  this->refs.clear();
+  this->retired.clear();
+  this->reloaded.clear();
+  this->stats = {};
+}
@@ -0,0 +1,93 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef SHADERLIBRARY_H
+#define SHADERLIBRARY_H
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "AssetArchive.h"
+
+//* owns every VkShaderModule of the renderer. SPIR-V is read through a file
+//* mapping and handed to vkCreateShaderModule in place, never copied. modules
+//* are keyed by a 128-bit hash of their words, so pipelines naming the same
+//* code (or the same file twice) share one module. callers must not destroy them.
+//* with an archive set, relative paths are looked up there before the disk
+class ShaderLibrary {
+ public:
+  struct Stats {
+    size_t modules = 0;  //? distinct modules created
+    size_t pathHits = 0;  //? path seen before, not even mapped again
+    size_t contentHits = 0;  //? new path, but identical code was already loaded
+  };
+
+ private:
+  static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+  //? two independent 64-bit hashes: wide enough that a collision aliasing two
+  //? shaders is not a practical concern, without keeping the words to compare
+  struct ContentHash {
+    uint64_t low = 0;
+    uint64_t high = 0;
+    bool operator==(const ContentHash& other) const {
+      return this->low == other.low && this->high == other.high;
+    }
+  };
+  struct ContentHasher {
+    size_t operator()(const ContentHash& hash) const {
+      return static_cast<size_t>(hash.low);
+    }
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  std::string root;  //? relative paths are resolved against it
+  const AssetArchive* archive = nullptr;  //? not owned
+  struct ModuleRefs {
+    ContentHash hash;
+    uint32_t paths = 0;  //? byPath entries naming the module
+    bool pinned = false;  //? handed out by load(code, size), never retired
+  };
+
+  std::unordered_map<ContentHash, VkShaderModule, ContentHasher> byContent;
+  std::unordered_map<std::string, VkShaderModule> byPath;
+  std::unordered_map<VkShaderModule, ModuleRefs> refs;
+  std::vector<VkShaderModule> retired;  //? replaced by a reload, destroyed by releaseRetired
+  std::unordered_set<std::string> reloaded;  //? resolved paths rewritten on disk, the archive copy is stale
+  Stats stats;
+  mutable std::mutex mutex;  //? pipeline builder workers load concurrently
+
+  static ContentHash hashCode(const uint32_t* words, size_t wordCount);
+  VkShaderModule create(const void* code, size_t size, const std::string& name);
+
+ public:
+  ShaderLibrary() = default;
+  ShaderLibrary(const ShaderLibrary&) = delete;
+  ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+  void init(VkDevice logicalDevice, const std::string& assetRoot);
+  //? nullptr (or a closed archive) falls back to loose files only
+  void setArchive(const AssetArchive* assetArchive) { this->archive = assetArchive; }
+  //? absolute paths are kept as they are
+  std::string resolve(const std::string& path) const;
+  VkShaderModule load(const std::string& path);
+  //? code must be 4-byte aligned SPIR-V, e.g. a blob inside a mapped archive
+  VkShaderModule load(const void* code, size_t size);
+  //? the next load(path) reads the file again (hot reload). the old module is
+  //? retired once no other path or load(code, size) uses it; pipelines built
+  //? from it stay valid, only builds still in flight need the module itself
+  void reload(const std::string& path);
+  bool hasRetired() const;
+  //! only once every pipeline build that could have loaded a retired module finished
+  void releaseRetired();
+  Stats getStats() const;
+  void destroy();
+};
+
+#endif  // SHADERLIBRARY_H
@@ -0,0 +1,40 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef SHADERVARIANT_H
+#define SHADERVARIANT_H
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+//* feature toggles of the built-in shaders, baked in as specialization
+//* constants so the driver folds the disabled paths away. bit i is
+//* constant_id i in vertex.vert / fragment.frag, keep them in sync
+enum ShaderFeature : uint32_t {
+  SHADER_FEATURE_INSTANCE_COLOR = 1u << 0,  //? vertex: multiply the per-instance tint
+  SHADER_FEATURE_TEXTURE = 1u << 1,         //? fragment: sample the bindless texture
+  SHADER_FEATURE_MATERIAL = 1u << 2,        //? fragment: multiply the material tint
+};
+constexpr uint32_t SHADER_FEATURE_COUNT = 3;
+//? what the shaders do without specialization, i.e. the built-in pipeline
+constexpr uint32_t SHADER_FEATURES_ALL = (1u << SHADER_FEATURE_COUNT) - 1;
+
+//* one VkBool32 per feature bit, in the layout VkSpecializationInfo wants
+struct ShaderSpecialization {
+  std::vector<VkSpecializationMapEntry> entries;
+  std::vector<uint32_t> data;
+};
+
+inline ShaderSpecialization makeShaderSpecialization(uint32_t features) {
+  ShaderSpecialization specialization;
+  for (uint32_t i = 0; i < SHADER_FEATURE_COUNT; i++) {
+    specialization.entries.push_back(
+        {i, static_cast<uint32_t>(i * sizeof(uint32_t)), sizeof(uint32_t)});
+    specialization.data.push_back((features >> i) & 1u ? VK_TRUE : VK_FALSE);
+  }
+  return specialization;
+}
+
+#endif  // SHADERVARIANT_H
@@ -0,0 +1,134 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "ShaderWatcher.h"
+
+#include <cstdio>
+#include <iostream>
+#include <set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <spawn.h>
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+namespace {
+std::string withSlash(std::string dir) {
+  if (!dir.empty() && dir.back() != '/') dir += '/';
+  return dir;
+}
+
+bool isShaderSource(const std::string &name) {
+  for (const char *stage : {".vert", ".frag", ".comp"}) {
+    const std::string suffix = stage;
+    if (name.size() > suffix.size() &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+      return true;
+  }
+  return false;
+}
+}  // namespace
+
+bool ShaderWatcher::start(const std::string &glslDir, const std::string &spvDir,
+                          const std::string &compilerPath) {
+  this->stop();
+  this->sourceDir = withSlash(glslDir);
+  this->outputDir = withSlash(spvDir);
+  this->compiler = compilerPath;
+#ifdef __linux__
+  this->notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (this->notifyFd < 0) return false;
+  //? CLOSE_WRITE for in-place saves, MOVED_TO for editors that save by rename
+  if (inotify_add_watch(this->notifyFd, this->sourceDir.c_str(),
+                        IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    std::cerr << "cannot watch shader directory " << this->sourceDir << std::endl;
+    close(this->notifyFd);
+    this->notifyFd = -1;
+    return false;
+  }
+  this->running = true;
+  this->thread = std::thread(&ShaderWatcher::run, this);
+  return true;
+#else
+  std::cerr << "shader hot reload needs inotify (Linux)" << std::endl;
+  return false;
+#endif
+}
+
+std::vector<std::string> ShaderWatcher::takeChanged() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  std::vector<std::string> names;
+  names.swap(this->changed);
+  return names;
+}
+
+void ShaderWatcher::stop() {
+  this->running = false;
+  if (this->thread.joinable()) this->thread.join();
+#ifdef __linux__
+  if (this->notifyFd >= 0) close(this->notifyFd);
+#endif
+  this->notifyFd = -1;
+}
+
+void ShaderWatcher::run() {
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+  while (this->running) {
+    pollfd descriptor = {this->notifyFd, POLLIN, 0};
+    if (poll(&descriptor, 1, POLL_MS) <= 0) continue;
+    //* drain everything queued: one save often fires several events
+    std::set<std::string> sources;
+    ssize_t length;
+    while ((length = read(this->notifyFd, buffer, sizeof(buffer))) > 0) {
+      for (ssize_t offset = 0; offset < length;) {
+        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+        if (event->len > 0 && isShaderSource(event->name)) sources.insert(event->name);
+        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      }
+    }
+    for (const auto &source : sources) {
+      std::string spvName;
+      if (!this->compile(source, spvName)) continue;
+      std::cout << "shader reloaded: " << spvName << std::endl;
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->changed.push_back(spvName);
+    }
+  }
+#endif
+}
+
+bool ShaderWatcher::compile(const std::string &sourceName, std::string &spvName) const {
+#ifdef __linux__
+  spvName = sourceName.substr(0, sourceName.find('.')) + ".spv";  //? <name>.<stage> -> <name>.spv
+  const std::string source = this->sourceDir + sourceName;
+  const std::string output = this->outputDir + spvName;
+  //? compile next to the target and rename over it, a reader never maps half a file
+  const std::string temporary = output + ".tmp";
+  const char *argv[] = {this->compiler.c_str(), source.c_str(), "-o",
+                        temporary.c_str(), nullptr};
+  pid_t child = 0;
+  if (posix_spawnp(&child, this->compiler.c_str(), nullptr, nullptr,
+                   const_cast<char *const *>(argv), environ) != 0) {
+    std::cerr << "failed to run shader compiler " << this->compiler << std::endl;
+    return false;
+  }
+  int status = 0;
+  if (waitpid(child, &status, 0) != child || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != 0) {
+    //? the compiler already printed the GLSL errors, keep the last good .spv
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return std::rename(temporary.c_str(), output.c_str()) == 0;
+#else
+  (void)sourceName;
+  (void)spvName;
+  return false;
+#endif
+}
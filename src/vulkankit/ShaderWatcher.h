@@ -0,0 +1,48 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef SHADERWATCHER_H
+#define SHADERWATCHER_H
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//* shader hot reload, step one: a background thread watches the GLSL source
+//* directory (inotify) and recompiles a saved <name>.<stage> into
+//* <outputDir>/<name>.spv with the offline compiler, the same mapping the
+//* build uses. the renderer polls takeChanged() between frames
+class ShaderWatcher {
+ private:
+  static constexpr int POLL_MS = 100;  //? how often the thread checks for stop()
+
+  std::string sourceDir;
+  std::string outputDir;
+  std::string compiler;
+  std::thread thread;
+  std::atomic<bool> running{false};
+  int notifyFd = -1;
+  std::mutex mutex;
+  std::vector<std::string> changed;  //? .spv names relative to outputDir, guarded by mutex
+
+  void run();
+  bool compile(const std::string& sourceName, std::string& spvName) const;
+
+ public:
+  ShaderWatcher() = default;
+  ShaderWatcher(const ShaderWatcher&) = delete;
+  ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+  ~ShaderWatcher() { this->stop(); }
+
+  //? false when watching is not supported here (Linux only) or the directory cannot be watched
+  bool start(const std::string& glslDir, const std::string& spvDir,
+             const std::string& compilerPath);
+  bool isRunning() const { return this->running.load(); }
+  //? recompiled shaders since the last call, never blocks on the compiler
+  std::vector<std::string> takeChanged();
+  void stop();
+};
+
+#endif  // SHADERWATCHER_H
@@ -0,0 +1,317 @@
+//
+// Created by adnan on 10/18/26.
+//
+#include "StagingUploader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+void StagingUploader::init(VkDevice logicalDevice, GpuAllocator &gpuAllocator,
+                           uint32_t transferFamilyIndex, VkQueue transfer,
+                           TimelineSemaphore &transferQueueTimeline,
+                           uint32_t graphicsFamilyIndex, VkQueue graphics,
+                           TimelineSemaphore &graphicsQueueTimeline,
+                           VkDeviceSize ringSize, VkDeviceSize copyAlignment) {
+  this->device = logicalDevice;
+  this->allocator = &gpuAllocator;
+  this->transferFamily = transferFamilyIndex;
+  this->graphicsFamily = graphicsFamilyIndex;
+  this->transferQueue = transfer;
+  this->graphicsQueue = graphics;
+  this->transferTimeline = &transferQueueTimeline;
+  this->graphicsTimeline = &graphicsQueueTimeline;
+  this->alignment = std::max<VkDeviceSize>(16, copyAlignment);
+  this->capacity = ringSize / this->alignment * this->alignment;
+  this->ring = gpuAllocator.createBuffer(
+      this->capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  VkCommandPoolCreateInfo poolCreateInfo = {};
+  poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+  VkCommandBufferAllocateInfo cmdAllocateInfo = {};
+  cmdAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  cmdAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  cmdAllocateInfo.commandBufferCount = 1;
+
+  for (auto &batch : this->batches) {
+    poolCreateInfo.queueFamilyIndex = this->transferFamily;
+    if (vkCreateCommandPool(this->device, &poolCreateInfo, nullptr,
+                            &batch.transferPool) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create transfer command pool");
+    cmdAllocateInfo.commandPool = batch.transferPool;
+    if (vkAllocateCommandBuffers(this->device, &cmdAllocateInfo,
+                                 &batch.transferCmd) != VK_SUCCESS)
+      throw std::runtime_error("Failed to allocate transfer command buffer");
+    if (this->sharedQueue()) continue;
+
+    poolCreateInfo.queueFamilyIndex = this->graphicsFamily;
+    if (vkCreateCommandPool(this->device, &poolCreateInfo, nullptr,
+                            &batch.graphicsPool) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create ownership command pool");
+    cmdAllocateInfo.commandPool = batch.graphicsPool;
+    if (vkAllocateCommandBuffers(this->device, &cmdAllocateInfo,
+                                 &batch.graphicsCmd) != VK_SUCCESS)
+      throw std::runtime_error("Failed to allocate ownership command buffer");
+  }
+}
+
+bool StagingUploader::retireOldest(bool wait) {
+  if (this->inFlightOrder.empty()) return false;
+  Batch &batch = this->batches[this->inFlightOrder.front()];
+  if (wait) {
+    this->graphicsTimeline->wait(batch.graphicsValue);
+  } else if (!this->graphicsTimeline->isComplete(batch.graphicsValue)) {
+    return false;
+  }
+  batch.inFlight = false;
+  this->tail = batch.ringEnd;
+  this->inFlightOrder.pop_front();
+  return true;
+}
+
+StagingUploader::Batch &StagingUploader::beginBatch() {
+  Batch &batch = this->batches[this->current];
+  if (batch.recording) return batch;
+  //? slot still owned by the GPU, wait for it (and everything before it)
+  while (batch.inFlight) this->retireOldest(true);
+  vkResetCommandPool(this->device, batch.transferPool, 0);
+  if (batch.graphicsPool != VK_NULL_HANDLE)
+    vkResetCommandPool(this->device, batch.graphicsPool, 0);
+  VkCommandBufferBeginInfo cmdBeginInfo = {};
+  cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (vkBeginCommandBuffer(batch.transferCmd, &cmdBeginInfo) != VK_SUCCESS)
+    throw std::runtime_error("failed to begin upload command buffer");
+  batch.recording = true;
+  batch.bufferBarriers.clear();
+  batch.imageBarriers.clear();
+  batch.dstStages = 0;
+  return batch;
+}
+
+VkDeviceSize StagingUploader::reserve(VkDeviceSize size) {
+  for (;;) {
+    const VkDeviceSize position = this->head % this->capacity;
+    //? never split a copy across the wrap point, pad to the start instead
+    const VkDeviceSize padding =
+        position + size > this->capacity ? this->capacity - position : 0;
+    if (this->head + padding + size - this->tail <= this->capacity) {
+      this->head += padding;
+      const VkDeviceSize offset = this->head % this->capacity;
+      this->head += (size + this->alignment - 1) / this->alignment * this->alignment;
+      return offset;
+    }
+    //* ring is full: submit pending copies and wait for the oldest batch
+    if (this->batches[this->current].recording) this->flush();
+    if (!this->retireOldest(true))
+      throw std::runtime_error("staging upload does not fit in the ring");
+  }
+}
+
+void StagingUploader::uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset,
+                                   const void *data, VkDeviceSize size,
+                                   VkAccessFlags dstAccess,
+                                   VkPipelineStageFlags dstStage) {
+  const VkDeviceSize maxChunk = this->capacity / 2;
+  VkDeviceSize copied = 0;
+  while (copied < size) {
+    const VkDeviceSize chunk = std::min(maxChunk, size - copied);
+    const VkDeviceSize offset = this->reserve(chunk);
+    std::memcpy(static_cast<char *>(this->ring.allocation.mapped) + offset,
+                static_cast<const char *>(data) + copied, chunk);
+    Batch &batch = this->beginBatch();
+    VkBufferCopy region = {};
+    region.srcOffset = offset;
+    region.dstOffset = dstOffset + copied;
+    region.size = chunk;
+    vkCmdCopyBuffer(batch.transferCmd, this->ring.buffer, dst, 1, &region);
+    copied += chunk;
+  }
+
+  //* one barrier for the whole range, recorded after its last copy
+  Batch &batch = this->beginBatch();
+  VkBufferMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = dstAccess;
+  barrier.srcQueueFamilyIndex =
+      this->sharedQueue() ? VK_QUEUE_FAMILY_IGNORED : this->transferFamily;
+  barrier.dstQueueFamilyIndex =
+      this->sharedQueue() ? VK_QUEUE_FAMILY_IGNORED : this->graphicsFamily;
+  barrier.buffer = dst;
+  barrier.offset = dstOffset;
+  barrier.size = size;
+  batch.bufferBarriers.push_back(barrier);
+  batch.dstStages |= dstStage;
+}
+
+void StagingUploader::uploadImage(VkImage dst, VkExtent3D extent,
+                                  const void *data, VkDeviceSize size,
+                                  VkImageLayout finalLayout,
+                                  VkAccessFlags dstAccess,
+                                  VkPipelineStageFlags dstStage) {
+  //! images are not split, the whole level has to fit in the ring
+  const VkDeviceSize offset = this->reserve(size);
+  std::memcpy(static_cast<char *>(this->ring.allocation.mapped) + offset, data,
+              size);
+  Batch &batch = this->beginBatch();
+
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = 0;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = dst;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+  vkCmdPipelineBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+
+  VkBufferImageCopy region = {};
+  region.bufferOffset = offset;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = extent;
+  vkCmdCopyBufferToImage(batch.transferCmd, this->ring.buffer, dst,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+  //* layout change rides on the ownership transfer (or the plain barrier)
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = dstAccess;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = finalLayout;
+  barrier.srcQueueFamilyIndex =
+      this->sharedQueue() ? VK_QUEUE_FAMILY_IGNORED : this->transferFamily;
+  barrier.dstQueueFamilyIndex =
+      this->sharedQueue() ? VK_QUEUE_FAMILY_IGNORED : this->graphicsFamily;
+  batch.imageBarriers.push_back(barrier);
+  batch.dstStages |= dstStage;
+}
+
+void StagingUploader::flush() {
+  Batch &batch = this->batches[this->current];
+  if (!batch.recording) return;
+  //? a ring-full flush can land between the chunks of one upload, before its barrier exists
+  if (batch.dstStages == 0) batch.dstStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+  if (this->sharedQueue()) {
+    //? same queue: a plain barrier makes the copies visible to later draws
+    vkCmdPipelineBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         batch.dstStages, 0, 0, nullptr,
+                         static_cast<uint32_t>(batch.bufferBarriers.size()),
+                         batch.bufferBarriers.data(),
+                         static_cast<uint32_t>(batch.imageBarriers.size()),
+                         batch.imageBarriers.data());
+  } else {
+    //? release half of the queue family ownership transfer (dst access is ignored here)
+    auto releaseBarriers = batch.bufferBarriers;
+    auto releaseImageBarriers = batch.imageBarriers;
+    for (auto &barrier : releaseBarriers) barrier.dstAccessMask = 0;
+    for (auto &barrier : releaseImageBarriers) barrier.dstAccessMask = 0;
+    vkCmdPipelineBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                         static_cast<uint32_t>(releaseBarriers.size()),
+                         releaseBarriers.data(),
+                         static_cast<uint32_t>(releaseImageBarriers.size()),
+                         releaseImageBarriers.data());
+  }
+  if (vkEndCommandBuffer(batch.transferCmd) != VK_SUCCESS)
+    throw std::runtime_error("failed to end upload command buffer");
+
+  //? on a shared queue the transfer timeline is the graphics one
+  const uint64_t transferValue = this->transferTimeline->next();
+  const VkSemaphore transferSemaphore = this->transferTimeline->get();
+  VkTimelineSemaphoreSubmitInfo transferTimelineInfo = {};
+  transferTimelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  transferTimelineInfo.signalSemaphoreValueCount = 1;
+  transferTimelineInfo.pSignalSemaphoreValues = &transferValue;
+  VkSubmitInfo transferSubmit = {};
+  transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  transferSubmit.pNext = &transferTimelineInfo;
+  transferSubmit.commandBufferCount = 1;
+  transferSubmit.pCommandBuffers = &batch.transferCmd;
+  transferSubmit.signalSemaphoreCount = 1;
+  transferSubmit.pSignalSemaphores = &transferSemaphore;
+  if (vkQueueSubmit(this->transferQueue, 1, &transferSubmit, VK_NULL_HANDLE) !=
+      VK_SUCCESS)
+    throw std::runtime_error("failed to submit uploads");
+  batch.graphicsValue = transferValue;
+
+  if (!this->sharedQueue()) {
+    //* acquire half, on the graphics queue behind the transfer semaphore
+    VkCommandBufferBeginInfo cmdBeginInfo = {};
+    cmdBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(batch.graphicsCmd, &cmdBeginInfo) != VK_SUCCESS)
+      throw std::runtime_error("failed to begin ownership command buffer");
+    auto acquireBarriers = batch.bufferBarriers;
+    auto acquireImageBarriers = batch.imageBarriers;
+    for (auto &barrier : acquireBarriers) barrier.srcAccessMask = 0;
+    for (auto &barrier : acquireImageBarriers) barrier.srcAccessMask = 0;
+    vkCmdPipelineBarrier(batch.graphicsCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         batch.dstStages, 0, 0, nullptr,
+                         static_cast<uint32_t>(acquireBarriers.size()),
+                         acquireBarriers.data(),
+                         static_cast<uint32_t>(acquireImageBarriers.size()),
+                         acquireImageBarriers.data());
+    if (vkEndCommandBuffer(batch.graphicsCmd) != VK_SUCCESS)
+      throw std::runtime_error("failed to end ownership command buffer");
+
+    const VkPipelineStageFlags waitStage = batch.dstStages;
+    const uint64_t acquireValue = this->graphicsTimeline->next();
+    const VkSemaphore graphicsSemaphore = this->graphicsTimeline->get();
+    VkTimelineSemaphoreSubmitInfo acquireTimelineInfo = {};
+    acquireTimelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    acquireTimelineInfo.waitSemaphoreValueCount = 1;
+    acquireTimelineInfo.pWaitSemaphoreValues = &transferValue;
+    acquireTimelineInfo.signalSemaphoreValueCount = 1;
+    acquireTimelineInfo.pSignalSemaphoreValues = &acquireValue;
+    VkSubmitInfo acquireSubmit = {};
+    acquireSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    acquireSubmit.pNext = &acquireTimelineInfo;
+    acquireSubmit.waitSemaphoreCount = 1;
+    acquireSubmit.pWaitSemaphores = &transferSemaphore;
+    acquireSubmit.pWaitDstStageMask = &waitStage;
+    acquireSubmit.commandBufferCount = 1;
+    acquireSubmit.pCommandBuffers = &batch.graphicsCmd;
+    acquireSubmit.signalSemaphoreCount = 1;
+    acquireSubmit.pSignalSemaphores = &graphicsSemaphore;
+    if (vkQueueSubmit(this->graphicsQueue, 1, &acquireSubmit, VK_NULL_HANDLE) !=
+        VK_SUCCESS)
+      throw std::runtime_error("failed to submit ownership acquire");
+    batch.graphicsValue = acquireValue;  //? implies the transfer half finished too
+  }
+
+  batch.recording = false;
+  batch.inFlight = true;
+  batch.ringEnd = this->head;
+  this->inFlightOrder.push_back(this->current);
+  this->current = (this->current + 1) % BATCH_COUNT;
+}
+
+void StagingUploader::collect() {
+  while (this->retireOldest(false)) {
+  }
+}
+
+void StagingUploader::destroy() {
+  if (this->device == VK_NULL_HANDLE) return;
+  while (this->retireOldest(true)) {
+  }
+  for (auto &batch : this->batches) {
+    if (batch.transferPool != VK_NULL_HANDLE)
+      vkDestroyCommandPool(this->device, batch.transferPool, nullptr);
+    if (batch.graphicsPool != VK_NULL_HANDLE)
+      vkDestroyCommandPool(this->device, batch.graphicsPool, nullptr);
+    batch = Batch{};
+  }
+  this->allocator->destroyBuffer(this->ring);
+  this->device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,88 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef STAGINGUPLOADER_H
+#define STAGINGUPLOADER_H
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <deque>
+#include <vector>
+
+#include "GpuAllocator.h"
+#include "TimelineSemaphore.h"
+
+//* streams data into DEVICE_LOCAL resources through a persistently mapped
+//* staging ring. copies run on the transfer queue; when that queue lives in a
+//* different family the destination is released there and acquired on the
+//* graphics queue behind the transfer timeline, so the graphics queue never
+//* waits on the CPU and the CPU only waits when the ring is full. a batch is
+//* retired once the graphics timeline passes the value of its last submission
+//! not thread safe: call from the thread that submits frames
+class StagingUploader {
+ private:
+  static constexpr uint32_t BATCH_COUNT = 4;
+  struct Batch {
+    VkCommandPool transferPool = VK_NULL_HANDLE;
+    VkCommandPool graphicsPool = VK_NULL_HANDLE;
+    VkCommandBuffer transferCmd = VK_NULL_HANDLE;
+    VkCommandBuffer graphicsCmd = VK_NULL_HANDLE;  //? ownership acquire, unused on a shared queue
+    uint64_t graphicsValue = 0;  //? graphics timeline value that retires the batch
+    VkDeviceSize ringEnd = 0;  //? ring position released once graphicsValue is reached
+    bool recording = false;
+    bool inFlight = false;
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    VkPipelineStageFlags dstStages = 0;
+  };
+
+  VkDevice device = VK_NULL_HANDLE;
+  GpuAllocator* allocator = nullptr;
+  uint32_t transferFamily = 0;
+  uint32_t graphicsFamily = 0;
+  VkQueue transferQueue = VK_NULL_HANDLE;
+  VkQueue graphicsQueue = VK_NULL_HANDLE;
+  TimelineSemaphore* transferTimeline = nullptr;  //? same object as graphicsTimeline on a shared queue
+  TimelineSemaphore* graphicsTimeline = nullptr;
+
+  GpuBuffer ring;
+  VkDeviceSize capacity = 0;
+  VkDeviceSize alignment = 16;
+  VkDeviceSize head = 0;  //? monotonic byte counters, position = counter % capacity
+  VkDeviceSize tail = 0;
+
+  std::array<Batch, BATCH_COUNT> batches;
+  uint32_t current = 0;
+  std::deque<uint32_t> inFlightOrder;  //? submission order == completion order
+
+  bool sharedQueue() const { return this->transferQueue == this->graphicsQueue; }
+  Batch& beginBatch();
+  VkDeviceSize reserve(VkDeviceSize size);
+  bool retireOldest(bool wait);
+
+ public:
+  StagingUploader() = default;
+  StagingUploader(const StagingUploader&) = delete;
+  StagingUploader& operator=(const StagingUploader&) = delete;
+
+  void init(VkDevice logicalDevice, GpuAllocator& gpuAllocator,
+            uint32_t transferFamilyIndex, VkQueue transfer,
+            TimelineSemaphore& transferQueueTimeline,
+            uint32_t graphicsFamilyIndex, VkQueue graphics,
+            TimelineSemaphore& graphicsQueueTimeline,
+            VkDeviceSize ringSize, VkDeviceSize copyAlignment);
+  //? dstAccess/dstStage describe the first graphics use of the data
+  void uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data,
+                    VkDeviceSize size, VkAccessFlags dstAccess,
+                    VkPipelineStageFlags dstStage);
+  //? single mip/layer color image, leaves it in finalLayout
+  void uploadImage(VkImage dst, VkExtent3D extent, const void* data,
+                   VkDeviceSize size, VkImageLayout finalLayout,
+                   VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+  void flush();
+  void collect();  //? non blocking: reclaim ring space of finished batches
+  void destroy();
+};
+
+#endif  // STAGINGUPLOADER_H
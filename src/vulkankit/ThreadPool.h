@@ -0,0 +1,83 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+//* fixed size worker pool, tasks receive the index of the worker running them
+//* so they can use per-worker resources (pipeline caches, command pools...)
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void(uint32_t)>> tasks;
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  bool stopping = false;
+
+  void workerLoop(uint32_t workerIndex) {
+    for (;;) {
+      std::function<void(uint32_t)> task;
+      {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->wakeUp.wait(lock,
+                          [this] { return this->stopping || !this->tasks.empty(); });
+        if (this->stopping && this->tasks.empty()) return;
+        task = std::move(this->tasks.front());
+        this->tasks.pop();
+      }
+      task(workerIndex);
+    }
+  }
+
+ public:
+  ThreadPool() = default;
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool() { this->stop(); }
+
+  void start(uint32_t threadCount) {
+    if (threadCount == 0) threadCount = 1;
+    this->stopping = false;
+    for (uint32_t i = 0; i < threadCount; i++)
+      this->workers.emplace_back([this, i] { this->workerLoop(i); });
+  }
+
+  //? finishes queued tasks, then joins
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->stopping = true;
+    }
+    this->wakeUp.notify_all();
+    for (auto& worker : this->workers) worker.join();
+    this->workers.clear();
+  }
+
+  uint32_t size() const { return static_cast<uint32_t>(this->workers.size()); }
+
+  template <typename F>
+  auto submit(F&& function) -> std::future<decltype(function(uint32_t{}))> {
+    using Result = decltype(function(uint32_t{}));
+    auto task = std::make_shared<std::packaged_task<Result(uint32_t)>>(
+        std::forward<F>(function));
+    auto future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->tasks.emplace([task](uint32_t workerIndex) { (*task)(workerIndex); });
+    }
+    this->wakeUp.notify_one();
+    return future;
+  }
+};
+
+#endif  // THREADPOOL_H
@@ -0,0 +1,74 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef TIMELINESEMAPHORE_H
+#define TIMELINESEMAPHORE_H
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+//* one monotonically increasing counter per queue. every submission to the
+//* queue signals the next value; the CPU (vkWaitSemaphores) and other queues
+//* wait on values, so there are no fences to reset and no binary semaphore
+//* per dependency.
+//! values must be signalled in submission order: take next() right before
+//! the vkQueueSubmit that signals it, on the submitting thread
+class TimelineSemaphore {
+ private:
+  VkDevice device = VK_NULL_HANDLE;
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  uint64_t lastSubmitted = 0;
+
+ public:
+  TimelineSemaphore() = default;
+  TimelineSemaphore(const TimelineSemaphore&) = delete;
+  TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+
+  void init(VkDevice logicalDevice) {
+    this->device = logicalDevice;
+    VkSemaphoreTypeCreateInfo typeCreateInfo = {};
+    typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeCreateInfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = &typeCreateInfo;
+    if (vkCreateSemaphore(this->device, &semaphoreCreateInfo, nullptr,
+                          &this->semaphore) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create timeline semaphore");
+  }
+
+  VkSemaphore get() const { return this->semaphore; }
+  //? value for the submission about to be made
+  uint64_t next() { return ++this->lastSubmitted; }
+  uint64_t getLastSubmitted() const { return this->lastSubmitted; }
+  uint64_t getCompleted() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(this->device, this->semaphore, &value);
+    return value;
+  }
+  bool isComplete(uint64_t value) const { return this->getCompleted() >= value; }
+  //? value 0 is always complete, so never-submitted slots do not block
+  void wait(uint64_t value,
+            uint64_t timeout = std::numeric_limits<uint64_t>::max()) const {
+    if (value == 0) return;
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &this->semaphore;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(this->device, &waitInfo, timeout);
+  }
+
+  void destroy() {
+    if (this->semaphore != VK_NULL_HANDLE)
+      vkDestroySemaphore(this->device, this->semaphore, nullptr);
+    this->semaphore = VK_NULL_HANDLE;
+    this->lastSubmitted = 0;
+  }
+};
+
+#endif  // TIMELINESEMAPHORE_H
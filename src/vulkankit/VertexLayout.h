@@ -0,0 +1,88 @@
+//
+// Created by adnan on 10/18/26.
+//
+
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+//* one vertex attribute: the Vulkan format and the bytes it takes in memory
+template <VkFormat Format, typename Component, uint32_t ComponentCount>
+struct VertexAttributeType {
+  static constexpr VkFormat format = Format;
+  static constexpr uint32_t size = sizeof(Component) * ComponentCount;
+  static_assert(size % 4 == 0, "keep attributes 4 byte aligned");
+};
+
+using AttributeFloat2 = VertexAttributeType<VK_FORMAT_R32G32_SFLOAT, float, 2>;
+using AttributeFloat3 = VertexAttributeType<VK_FORMAT_R32G32B32_SFLOAT, float, 3>;
+using AttributeFloat4 = VertexAttributeType<VK_FORMAT_R32G32B32A32_SFLOAT, float, 4>;
+using AttributeSnorm16x2 = VertexAttributeType<VK_FORMAT_R16G16_SNORM, int16_t, 2>;
+using AttributeSnorm16x4 = VertexAttributeType<VK_FORMAT_R16G16B16A16_SNORM, int16_t, 4>;
+using AttributeUnorm16x2 = VertexAttributeType<VK_FORMAT_R16G16_UNORM, uint16_t, 2>;
+using AttributeUnorm8x4 = VertexAttributeType<VK_FORMAT_R8G8B8A8_UNORM, uint8_t, 4>;
+
+//* binding + attribute descriptions of one tightly packed vertex stream,
+//* generated at compile time from the attribute list (in declaration order)
+template <VkVertexInputRate InputRate, typename... Attributes>
+struct VertexLayout {
+  static_assert(sizeof...(Attributes) > 0, "a vertex layout needs attributes");
+  static constexpr uint32_t attributeCount = sizeof...(Attributes);
+  static constexpr uint32_t stride = (Attributes::size + ...);
+
+  static constexpr uint32_t offsetOf(uint32_t index) {
+    constexpr uint32_t sizes[] = {Attributes::size...};
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < index; i++) offset += sizes[i];
+    return offset;
+  }
+
+  static constexpr VkVertexInputBindingDescription binding(
+      uint32_t bindingIndex) {
+    return {bindingIndex, stride, InputRate};
+  }
+
+  //? locations are assigned in order starting at firstLocation
+  static constexpr std::array<VkVertexInputAttributeDescription, attributeCount>
+  attributes(uint32_t bindingIndex, uint32_t firstLocation = 0) {
+    constexpr VkFormat formats[] = {Attributes::format...};
+    std::array<VkVertexInputAttributeDescription, attributeCount> result = {};
+    for (uint32_t i = 0; i < attributeCount; i++) {
+      result[i] = {firstLocation + i, bindingIndex, formats[i], offsetOf(i)};
+    }
+    return result;
+  }
+};
+
+//* quantization helpers, decoded by the input assembler (snorm/unorm formats)
+inline int16_t quantizeSnorm16(float value) {
+  return static_cast<int16_t>(
+      std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline uint8_t quantizeUnorm8(float value) {
+  return static_cast<uint8_t>(
+      std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+//? octahedral normal encoding, must match octDecode() in the vertex shader
+inline std::array<int16_t, 2> octEncodeSnorm16(float x, float y, float z) {
+  const float length = std::abs(x) + std::abs(y) + std::abs(z);
+  if (length == 0.0f) return {0, 0};
+  float u = x / length;
+  float v = y / length;
+  if (z < 0.0f) {
+    const float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    const float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    u = foldedU;
+    v = foldedV;
+  }
+  return {quantizeSnorm16(u), quantizeSnorm16(v)};
+}
+
+#endif  // VERTEXLAYOUT_H